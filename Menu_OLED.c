@@ -2,7 +2,11 @@
 #include "pico/stdlib.h"
 #include "hardware/i2c.h"
 #include "ssd1306.h"
-#include "hardware/adc.h"
+#include "ssd1306_menu.h"
+#include "adc_service.h"
+#include "sched.h"
+#include "input.h"
+#include "joystick.h"
 
 // Inclusão dos módulos dos programas
 #include "programa1.h"   // Módulo do Joystick (Prog 1)
@@ -13,7 +17,12 @@
 #define I2C_SCL 14
 
 #define SW 22    // Botão do Joystick (usado para seleção e para interromper os programas)
-#define VRY 26   // ADC do eixo vertical do Joystick
+#define VRY_CHANNEL 0       // Canal ADC do eixo vertical do Joystick (GPIO 26)
+#define VRX_CHANNEL 1       // Canal ADC do eixo horizontal do Joystick (GPIO 27)
+#define ADC_RATE_HZ 8000    // Conversões por segundo, divididas entre os canais
+
+#define MENU_PERIOD_MS 20   // Intervalo de leitura do joystick
+#define MENU_EVENT_INPUT 1  // Evento da tarefa do menu: botão
 
 // Instância do display OLED
 ssd1306_t disp;
@@ -32,107 +41,113 @@ void init_display() {
     ssd1306_clear(&disp);
 }
 
-// Função auxiliar para desenhar uma string no display
-void display_text(int x, int y, int scale, const char *text) {
-    ssd1306_draw_string(&disp, x, y, scale, (char *)text);
-    ssd1306_show(&disp);
+static ssd1306_menu_t menu;
+static sched_task_t menu_task;       // Tarefa do menu: botão, joystick e fim dos programas
+static input_pin_t sw_pin;           // Botão, tratado por interrupção
+static void (*running_stop)(void);   // Encerramento do programa em execução, NULL no menu
+static joystick_t stick;             // Joystick calibrado e filtrado, com repetição acelerada
+
+// Ações do menu: cada programa roda como tarefa ao lado do menu, que guarda como encerrá-lo
+static void start_joystick(void) {
+    running_stop = joystickProgramStop;
+    joystickProgramStart(&menu_task);
+}
+
+static void start_buzzer(void) {
+    running_stop = buzzerProgramStop;
+    buzzerProgramStart(&menu_task);
+}
+
+static void start_led_rgb(void) {
+    running_stop = ledRgbProgramStop;
+    ledRgbProgramStart(&menu_task);
 }
 
-// Função auxiliar para desenhar um retângulo vazio
-void display_rect(int x1, int y1, int x2, int y2) {
-    ssd1306_draw_empty_square(&disp, x1, y1, x2, y2);
+// Entradas do menu; a seleção executa a ação do item
+static const ssd1306_menu_item_t menu_items[] = {
+    {"1. Joystick LED", start_joystick},
+    {"2. Buzzer", start_buzzer},
+    {"3. LED RGB", start_led_rgb},
+};
+
+// Exibe o menu inteiro no OLED com a opção selecionada destacada
+void print_menu(void) {
+    ssd1306_menu_draw(&menu);
     ssd1306_show(&disp);
 }
 
-// Exibe o menu no OLED com a opção selecionada destacada
-void print_menu(uint8_t sel) {
-    ssd1306_clear(&disp);
-    
-    // Cabeçalho do menu
-    display_text(52, 2, 1, "MENU");
-    
-    // Opções do menu
-    display_text(6, 18, 1.5, "1. Joystick LED");
-    display_text(6, 30, 1.5, "2. Buzzer");
-    display_text(6, 42, 1.5, "3. LED RGB");
-    
-    // Define a posição vertical para o retângulo da opção selecionada
-    int rect_y;
-    if (sel == 1)
-        rect_y = 16;
-    else if (sel == 2)
-        rect_y = 28;
-    else if(sel == 3)
-        rect_y = 40;
-    
-    // Desenha um retângulo menor para destacar a opção selecionada
-    // Neste exemplo, o retângulo tem altura de 8 pixels (de rect_y a rect_y+8)
-    display_rect(2,rect_y+2,120,12);
+// Navegação pelo eixo vertical; mantido, o joystick repete cada vez mais rápido
+static void navigate(void) {
+    uint32_t steps = joystick_update(&stick, adc_service_read(VRX_CHANNEL), adc_service_read(VRY_CHANNEL), sched_now());
+
+    // Joystick para baixo (valor menor do ADC) incrementa a seleção
+    int32_t delta = ((steps & JOYSTICK_DOWN) ? 1 : 0) - ((steps & JOYSTICK_UP) ? 1 : 0);
+
+    // Só as faixas da seleção antiga e da nova são redesenhadas e enviadas
+    if (delta && ssd1306_menu_move(&menu, delta))
+        ssd1306_show(&disp);
+}
+
+// Volta ao menu: redesenha e retoma a leitura do joystick. Toques ainda na fila eram para
+// o programa que acabou (ex.: parar a música que terminou sozinha) e não iniciam outro
+static void back_to_menu(sched_task_t *t) {
+    running_stop = NULL;
+    input_flush();
+    print_menu();
+    sched_every(t, MENU_PERIOD_MS * 1000);
+}
+
+static void menu_task_fn(sched_task_t *t) {
+    // O programa terminou sozinho (fim da música)
+    if (t->fired & SCHED_EVENT_DONE)
+        back_to_menu(t);
+
+    // O botão inicia o programa selecionado ou encerra o que está rodando
+    input_event_t e;
+    while (input_get(&e)) {
+        if (e.gpio != SW || e.type != INPUT_PRESS)
+            continue;
+        if (!running_stop) {
+            // Sem leitura do joystick enquanto o programa roda
+            sched_cancel(t);
+            ssd1306_menu_activate(&menu);
+        } else {
+            running_stop();
+            back_to_menu(t);
+        }
+    }
+
+    if (t->expired && !running_stop)
+        navigate();
 }
 
 int main() {
     // Inicializações do display, ADC e botão
     init_display();
     
-    // Configuração do pino do botão (SW)
-    gpio_init(SW);
-    gpio_set_dir(SW, GPIO_IN);
-    gpio_pull_up(SW);
+    // ADC em amostragem contínua por DMA, compartilhado com os programas
+    adc_service_init(ADC_RATE_HZ);
+    adc_service_add(VRY_CHANNEL, 2);
+    adc_service_add(VRX_CHANNEL, 2);
     
-    // Inicializa o ADC para o joystick (pino VRY)
-    adc_init();
-    adc_gpio_init(VRY);
+    // O centro é medido nas primeiras leituras, com o joystick solto
+    joystick_init(&stick);
     
-    // Variável para o item selecionado do menu (1 a 3)
-    uint8_t menu_sel = 1;
-    print_menu(menu_sel);
+    // Menu com título, a seleção começa no primeiro item
+    ssd1306_menu_init(&menu, &disp, "MENU", menu_items, sizeof(menu_items) / sizeof(menu_items[0]), NULL);
+    print_menu();
     
-    while (true) {
-        // Leitura do ADC (canal 0) para navegação vertical
-        adc_select_input(0);
-        uint16_t adc_val = adc_read();
-        
-        // Invertendo a lógica:
-        // Se o valor lido for menor (joystick movido para baixo), incrementa a seleção.
-        if (adc_val < 1500) {
-            if (menu_sel < 3) {
-                menu_sel++;
-                print_menu(menu_sel);
-                sleep_ms(200); // Delay para debounce
-            }
-        }
-        // Se o valor lido for maior (joystick movido para cima), decrementa a seleção.
-        else if (adc_val > 2500) {
-            if (menu_sel > 1) {
-                menu_sel--;
-                print_menu(menu_sel);
-                sleep_ms(200);
-            }
-        }
-        
-        // Se o botão for pressionado, seleciona a opção atual
-        if (gpio_get(SW) == 0) {
-            sleep_ms(200); // Debounce
-            switch (menu_sel) {
-                case 1:
-                    // Executa o programa do Joystick (Prog 1)
-                    joystickProgram();
-                    break;
-                case 2:
-                    // Executa o programa do Buzzer (Prog 2)
-                    buzzerProgram();
-                    break;
-                case 3:
-                    ledRgbProgram();
-                    break;
-                default:
-                    break;
-            }
-            // Após a execução, reexibe o menu
-            print_menu(menu_sel);
-        }
-        sleep_ms(50);
-    }
+    // O menu é uma tarefa periódica; os programas rodam como tarefas ao lado dela
+    sched_init(NULL);
+    sched_add(&menu_task, "menu", menu_task_fn, NULL);
+    sched_every(&menu_task, MENU_PERIOD_MS * 1000);
+    sched_wait(&menu_task, SCHED_EVENT_DONE | MENU_EVENT_INPUT);
+    
+    // Botão (SW) por interrupção: cada evento acorda a tarefa do menu
+    input_init(&menu_task, MENU_EVENT_INPUT);
+    input_pin_init(&sw_pin, SW, true);
+    input_add(&sw_pin);
+    sched_run();
     
     return 0;
 }
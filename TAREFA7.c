@@ -1,6 +1,6 @@
 // Bibliotecas necessárias
 #include "pico/stdlib.h"          // Biblioteca padrão do Pico
-#include "hardware/adc.h"         // Biblioteca para ADC (Conversor Analógico-Digital)
+#include "adc_service.h"          // Serviço de ADC contínuo por DMA
 #include "hardware/i2c.h"         // Biblioteca para comunicação I2C
 #include "libs/ssd1306.h"         // Biblioteca para controle do display OLED SSD1306
 #include "pico/cyw43_arch.h"      // Biblioteca para controle do hardware Wi-Fi CYW43
@@ -11,7 +11,8 @@
 // Definições de Hardware
 #define RED_LED_PIN 11            // Pino GPIO do LED vermelho
 #define GREEN_LED_PIN 13           // Pino GPIO do LED verde
-#define MICROFONE_PIN 28           // Pino do microfone (Canal ADC2)
+#define MICROFONE_CHANNEL 2        // Canal ADC2 do microfone (GPIO 28)
+#define MICROFONE_RATE_HZ 10000    // Uma amostra a cada 100 us
 #define VOICE_THRESHOLD 30         // Limite para detecção de voz
 #define LOUD_THRESHOLD 3750        // Limite para detecção de som alto
 #define SAMPLE_COUNT 100           // Número de amostras para leitura
@@ -46,9 +47,8 @@ void init_hardware() {
     gpio_init(GREEN_LED_PIN);      // Inicializa pino do LED verde
     gpio_set_dir(GREEN_LED_PIN, GPIO_OUT); // Configura como saída
 
-    adc_init();                    // Inicializa o ADC
-    adc_gpio_init(MICROFONE_PIN);  // Configura pino do microfone para ADC
-    adc_select_input(2);           // Seleciona canal ADC2
+    adc_service_init(MICROFONE_RATE_HZ); // ADC contínuo por DMA
+    adc_service_add(MICROFONE_CHANNEL, 0); // Microfone, sem média
 
     // Configuração do I2C para o display
     i2c_init(I2C_DISPLAY, 400000); // Inicializa I2C a 400kHz
@@ -65,7 +65,7 @@ void init_hardware() {
     uint32_t sum = 0;
     uint16_t max_val = 0;
     for (int i = 0; i < SAMPLE_COUNT; i++) {
-        uint16_t val = adc_read(); // Lê valor do ADC
+        uint16_t val = adc_service_read(MICROFONE_CHANNEL); // Última amostra
         sum += val;                // Acumula para média
         if(val > max_val) max_val = val; // Atualiza máximo
         sleep_ms(10);              // Intervalo entre amostras
@@ -83,17 +83,31 @@ void init_hardware() {
 
 // Atualização do Display
 void update_display(bool loud, bool voice) {
+    static bool marquee = false;   // Aviso de ruído rolando no painel
+
     ssd1306_clear(&display);       // Limpa o buffer do display
     
     if(loud) {                     // Se detectar som alto
         ssd1306_draw_string(&display, 43, 20, 1, "PERIGO!");
-        ssd1306_draw_string(&display, 13, 30, 1, "RUIDO ALTO!CUIDADO!");
+        ssd1306_draw_string(&display, 13, 32, 1, "RUIDO ALTO!CUIDADO!");
     } else if(voice) {            // Se detectar voz normal
         ssd1306_draw_string(&display, 34, 30, 1, "SOM NORMAL");
     } else {                       // Ambiente silencioso
         ssd1306_draw_string(&display, 31, 30, 1, "Ambiente OK");
     }
-    ssd1306_show(&display);        // Atualiza o display físico
+
+    // O aviso ocupa só a página 4 (linhas 32-39) e o próprio painel o faz
+    // rolar, sem tráfego I2C enquanto o alerta durar
+    if(loud && !marquee) {
+        ssd1306_scroll_horizontal(&display, 4, 4, true, 4);
+        marquee = true;
+    } else if(!loud && marquee) {
+        ssd1306_scroll_stop(&display);   // A página 4 é reenviada abaixo
+        marquee = false;
+    }
+    // Envia em segundo plano (DMA); se o envio anterior ainda não terminou,
+    // as áreas alteradas continuam marcadas e vão no próximo ciclo
+    ssd1306_show_async(&display, NULL, NULL);
 }
 
 // Callback de DNS
@@ -192,12 +206,13 @@ int main() {
         uint16_t peak = 0;         // Pico de som detectado
         uint32_t sum_dev = 0;      // Soma das variações
 
-        // Coleta 100 amostras do microfone
+        // Últimas 100 amostras do microfone (10 ms), já capturadas pelo DMA
+        uint16_t samples[SAMPLE_COUNT];
+        adc_service_block(MICROFONE_CHANNEL, samples, SAMPLE_COUNT);
         for(int i = 0; i < SAMPLE_COUNT; i++) {
-            uint16_t val = adc_read(); 
+            uint16_t val = samples[i];
             if(val > peak) peak = val;             // Atualiza pico
             sum_dev += abs(val - baseline_noise);  // Calcula desvio
-            sleep_us(100);            // Intervalo entre amostras
         }
 
         // Determina estados de detecção
@@ -0,0 +1,178 @@
+/**
+* @file adc_service.c
+*
+* free-running ADC acquisition shared by all modules
+*/
+
+#include <pico/stdlib.h>
+#include <hardware/adc.h>
+#include <hardware/clocks.h>
+#include <hardware/dma.h>
+
+#include "adc_service.h"
+
+static uint16_t adc_service_ring[ADC_SERVICE_CHANNELS*ADC_SERVICE_DEPTH] __attribute__((aligned(4)));
+static uint16_t *adc_service_ring_start=adc_service_ring;
+
+static int adc_service_data=-1, adc_service_ctrl=-1;
+static uint32_t adc_service_rate_hz;
+static uint32_t adc_service_mask;
+static uint8_t adc_service_oversample[ADC_SERVICE_CHANNELS];
+// channel -> position in a round of the round robin, and the number of channels
+static uint8_t adc_service_slot[ADC_SERVICE_CHANNELS];
+static uint32_t adc_service_count;
+
+inline static uint32_t adc_service_len(void) {
+    return adc_service_count*ADC_SERVICE_DEPTH;
+}
+
+static void adc_service_stop(void) {
+    adc_run(false);
+
+    // RP2040-E13: an aborted channel may still trigger its chain, so the data channel chains
+    // to itself first and the control channel cannot restart it
+    dma_channel_config c=dma_get_channel_config(adc_service_data);
+    channel_config_set_chain_to(&c, adc_service_data);
+    dma_channel_set_config(adc_service_data, &c, false);
+
+    dma_channel_abort(adc_service_ctrl);
+    dma_channel_abort(adc_service_data);
+    // both idle before adc_service_start reconfigures them
+    while(dma_channel_is_busy(adc_service_ctrl) || dma_channel_is_busy(adc_service_data))
+        tight_loop_contents();
+    adc_fifo_drain();
+}
+
+// the round robin goes through the mask upwards, starting at the selected input
+static void adc_service_start(void) {
+    adc_service_count=0;
+    for(uint32_t ch=0; ch<ADC_SERVICE_CHANNELS; ++ch)
+        if(adc_service_mask&(1u<<ch))
+            adc_service_slot[ch]=adc_service_count++;
+    if(!adc_service_count)
+        return;
+
+    // one conversion per channel in every slot, no reader sees an empty buffer
+    adc_set_round_robin(0);
+    adc_fifo_setup(false, false, 1, false, false);
+    for(uint32_t ch=0; ch<ADC_SERVICE_CHANNELS; ++ch) {
+        if(!(adc_service_mask&(1u<<ch)))
+            continue;
+        adc_select_input(ch);
+        const uint16_t v=adc_read();
+        for(uint32_t i=adc_service_slot[ch]; i<adc_service_len(); i+=adc_service_count)
+            adc_service_ring[i]=v;
+    }
+
+    adc_select_input(__builtin_ctz(adc_service_mask));
+    adc_set_round_robin(adc_service_mask);
+    adc_fifo_setup(true, true, 1, false, false);
+
+    const uint32_t div=clock_get_hz(clk_adc)/adc_service_rate_hz;
+    adc_set_clkdiv(div>0?div-1:0);
+
+    dma_channel_config c=dma_channel_get_default_config(adc_service_data);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+    channel_config_set_read_increment(&c, false);
+    channel_config_set_write_increment(&c, true);
+    channel_config_set_dreq(&c, DREQ_ADC);
+    channel_config_set_chain_to(&c, adc_service_ctrl);
+    dma_channel_configure(adc_service_data, &c, adc_service_ring, &adc_hw->fifo, adc_service_len(), false);
+
+    // rewrites the write address of the data channel, which also triggers it
+    dma_channel_config cc=dma_channel_get_default_config(adc_service_ctrl);
+    channel_config_set_transfer_data_size(&cc, DMA_SIZE_32);
+    channel_config_set_read_increment(&cc, false);
+    channel_config_set_write_increment(&cc, false);
+    dma_channel_configure(adc_service_ctrl, &cc, &dma_hw->ch[adc_service_data].al2_write_addr_trig, &adc_service_ring_start, 1, false);
+
+    dma_channel_start(adc_service_data);
+    adc_run(true);
+}
+
+bool adc_service_init(uint32_t rate_hz) {
+    if(adc_service_data<0) {
+        adc_service_data=dma_claim_unused_channel(false);
+        adc_service_ctrl=dma_claim_unused_channel(false);
+        if(adc_service_data<0 || adc_service_ctrl<0) {
+            if(adc_service_data>=0)
+                dma_channel_unclaim(adc_service_data);
+            adc_service_data=adc_service_ctrl=-1;
+            return false;
+        }
+        adc_init();
+    } else {
+        adc_service_stop();
+    }
+
+    adc_service_rate_hz=rate_hz?rate_hz:1;
+    adc_service_start();
+    return true;
+}
+
+bool adc_service_add(uint32_t channel, uint8_t oversample_log2) {
+    if(channel>=ADC_SERVICE_CHANNELS || adc_service_data<0)
+        return false;
+
+    while((1u<<oversample_log2)>ADC_SERVICE_DEPTH)
+        --oversample_log2;
+    adc_service_oversample[channel]=oversample_log2;
+
+    if(adc_service_mask&(1u<<channel))
+        return true;
+
+    if(channel==4)
+        adc_set_temp_sensor_enabled(true);
+    else
+        adc_gpio_init(26+channel);
+
+    adc_service_stop();
+    adc_service_mask|=1u<<channel;
+    adc_service_start();
+    return true;
+}
+
+// ring index of the latest sample of a channel
+static uint32_t adc_service_latest(uint32_t channel) {
+    const uint32_t len=adc_service_len();
+    // the write address is the end of the buffer for a moment before the restart
+    const uint32_t w=((const uint16_t *) (uintptr_t) dma_hw->ch[adc_service_data].write_addr-adc_service_ring)%len+len;
+    return (w-1-(w-1-adc_service_slot[channel])%adc_service_count)%len;
+}
+
+uint16_t adc_service_read(uint32_t channel) {
+    if(channel>=ADC_SERVICE_CHANNELS || !(adc_service_mask&(1u<<channel)))
+        return 0;
+
+    const uint32_t len=adc_service_len(), n=1u<<adc_service_oversample[channel];
+    uint32_t i=adc_service_latest(channel), sum=0;
+    for(uint32_t k=0; k<n; ++k) {
+        sum+=adc_service_ring[i];
+        i=(i+len-adc_service_count)%len;
+    }
+    return sum>>adc_service_oversample[channel];
+}
+
+uint32_t adc_service_block(uint32_t channel, uint16_t *dst, uint32_t n) {
+    if(channel>=ADC_SERVICE_CHANNELS || !(adc_service_mask&(1u<<channel)))
+        return 0;
+    if(n>ADC_SERVICE_DEPTH)
+        n=ADC_SERVICE_DEPTH;
+
+    const uint32_t len=adc_service_len();
+    uint32_t i=adc_service_latest(channel);
+    for(uint32_t k=n; k-->0;) {
+        dst[k]=adc_service_ring[i];
+        i=(i+len-adc_service_count)%len;
+    }
+    return n;
+}
+
+uint32_t adc_service_rate(uint32_t channel) {
+    if(channel>=ADC_SERVICE_CHANNELS || !(adc_service_mask&(1u<<channel)))
+        return 0;
+
+    // the conversion takes 96 ADC clocks at least
+    const uint32_t div=clock_get_hz(clk_adc)/adc_service_rate_hz;
+    return clock_get_hz(clk_adc)/(div>96?div:96)/adc_service_count;
+}
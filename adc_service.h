@@ -0,0 +1,96 @@
+/**
+* @file adc_service.h
+*
+* free-running ADC acquisition shared by all modules
+*
+* the ADC converts the registered channels in round-robin into its FIFO, a DMA channel moves
+* the samples into a circular buffer and a second DMA channel restarts it at the end, so
+* sampling goes on without CPU. the buffer holds the last ADC_SERVICE_DEPTH samples of every
+* channel, interleaved; readers take the latest value, averaged over a per-channel number of
+* samples (oversampling), or the latest block of samples, without waiting and without
+* touching the input mux. the buffer is filled with one conversion per channel when the
+* sampling (re)starts, so reads are valid right away
+*/
+
+#ifndef _inc_adc_service
+#define _inc_adc_service
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+*	@brief samples kept per channel, power of 2
+*/
+#ifndef ADC_SERVICE_DEPTH
+#define ADC_SERVICE_DEPTH 128
+#endif
+
+/**
+*	@brief number of ADC inputs, 4 is the temperature sensor
+*/
+#define ADC_SERVICE_CHANNELS 5
+
+/**
+	@brief initialize the ADC and claim two DMA channels, no channel sampled yet
+
+	calling it again only changes the rate
+
+	@param[in] rate_hz : conversions per second over all channels, at most 500000
+
+	@return false if no DMA channels are free
+*/
+bool adc_service_init(uint32_t rate_hz);
+
+/**
+	@brief sample a channel, restarts the sampling if it was not sampled yet
+
+	the rate of a channel is the rate of adc_service_init divided by the number of channels
+
+	@param[in] channel : ADC input, 0-3 for GPIO 26-29, 4 for the temperature sensor
+	@param[in] oversample_log2 : adc_service_read averages 2^oversample_log2 samples
+
+	@return false if the channel does not exist or adc_service_init failed
+*/
+bool adc_service_add(uint32_t channel, uint8_t oversample_log2);
+
+/**
+	@brief latest value of a channel
+
+	@param[in] channel : sampled ADC input
+
+	@return mean of the last 2^oversample_log2 samples, 12 bits; 0 if not sampled
+*/
+uint16_t adc_service_read(uint32_t channel);
+
+/**
+	@brief latest samples of a channel
+
+	samples are overwritten while being copied only if n is close to ADC_SERVICE_DEPTH and the
+	copy takes longer than the samples left in the buffer
+
+	@param[in] channel : sampled ADC input
+	@param[out] dst : samples, oldest first
+	@param[in] n : number of samples, at most ADC_SERVICE_DEPTH
+
+	@return number of samples copied
+*/
+uint32_t adc_service_block(uint32_t channel, uint16_t *dst, uint32_t n);
+
+/**
+	@brief samples per second of a channel
+
+	@param[in] channel : ADC input
+
+	@return rate, 0 if not sampled
+*/
+uint32_t adc_service_rate(uint32_t channel);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -6,6 +6,21 @@
  * <height>, <width>, <additional spacing per char>, 
  * <first ascii char>, <last ascii char>,
  * <data>
+ *
+ * Proportional format (marked by height 0)
+ * 0, <flags, 0>, <height>, <additional spacing per char>,
+ * <first ascii char>, <last ascii char>, <number of kerning pairs>,
+ * <index: data offset low byte, data offset high byte, width; per char>,
+ * <kerning: left char, right char, signed adjustment; per pair>,
+ * <data>
+ *
+ * data holds every glyph column by column, (height+7)/8 bytes per column,
+ * least significant bit on top
+ *
+ * flags bit 0: glyph data is run length encoded page by page (every
+ * column of the top page first), each run starts with
+ * 0x00-0x7f (n+1 literal bytes follow) or 0x80-0xff (next byte repeated
+ * n-0x80+2 times); tools/ssd1306_fontc.py generates this format
  */
 const uint8_t font_8x5[] =
 {
@@ -0,0 +1,138 @@
+/**
+* @file input.c
+*
+* interrupt driven debounced buttons, hardware side
+*/
+
+#include <pico/stdlib.h>
+#include <hardware/gpio.h>
+#include <hardware/irq.h>
+#include <hardware/sync.h>
+
+#include "input.h"
+
+static input_pin_t *input_pins[NUM_BANK0_GPIOS];
+static input_queue_t input_queue;
+static sched_task_t *input_notify;
+static uint32_t input_notify_events;
+static alarm_id_t input_alarm;
+static uint64_t input_alarm_at=INPUT_NEVER;
+
+static void input_arm(uint64_t until);
+
+// called from the GPIO and alarm interrupts, which have the same priority and do not nest
+static void input_delivered(uint32_t head) {
+    if(input_queue.head!=head) {
+        if(input_notify)
+            sched_signal(input_notify, input_notify_events);
+        else
+            __sev();
+    }
+}
+
+static int64_t input_alarm_cb(alarm_id_t id, void *user_data) {
+    (void) id;
+    (void) user_data;
+    const uint64_t now=time_us_64();
+    const uint32_t head=input_queue.head;
+
+    uint64_t next=INPUT_NEVER;
+    for(uint32_t i=0; i<NUM_BANK0_GPIOS; ++i) {
+        if(input_pins[i]) {
+            const uint64_t t=input_pin_timeout(input_pins[i], now, &input_queue);
+            if(t<next)
+                next=t;
+        }
+    }
+
+    input_alarm=0;
+    input_alarm_at=INPUT_NEVER;
+    input_arm(next);
+    input_delivered(head);
+    return 0;
+}
+
+// one alarm for the earliest deadline of all pins, the callback looks at every pin
+static void input_arm(uint64_t until) {
+    if(until>=input_alarm_at)
+        return;
+    if(input_alarm)
+        cancel_alarm(input_alarm);
+
+    input_alarm_at=until;
+    input_alarm=add_alarm_at(from_us_since_boot(until), input_alarm_cb, NULL, true);
+}
+
+static void input_gpio_cb(uint gpio, uint32_t events) {
+    (void) events;
+    input_pin_t *pin=gpio<NUM_BANK0_GPIOS?input_pins[gpio]:NULL;
+    if(!pin)
+        return;
+
+    const uint32_t head=input_queue.head;
+    const uint64_t next=input_pin_edge(pin, gpio_get(gpio), time_us_64(), &input_queue);
+    input_arm(next);
+    input_delivered(head);
+}
+
+void input_init(sched_task_t *notify, uint32_t events) {
+    input_notify=notify;
+    input_notify_events=events;
+    gpio_set_irq_callback(input_gpio_cb);
+    irq_set_enabled(IO_IRQ_BANK0, true);
+}
+
+void input_add(input_pin_t *pin) {
+    gpio_init(pin->gpio);
+    gpio_set_dir(pin->gpio, GPIO_IN);
+    if(pin->active_low)
+        gpio_pull_up(pin->gpio);
+    else
+        gpio_pull_down(pin->gpio);
+
+    // a button held at boot produces no press
+    busy_wait_us(1);
+    pin->level=gpio_get(pin->gpio)!=pin->active_low;
+    pin->pressed=pin->level;
+    pin->settle=INPUT_NEVER;
+    pin->hold=INPUT_NEVER;
+
+    const uint32_t irq=save_and_disable_interrupts();
+    input_pins[pin->gpio]=pin;
+    restore_interrupts(irq);
+
+    gpio_set_irq_enabled(pin->gpio, GPIO_IRQ_EDGE_RISE|GPIO_IRQ_EDGE_FALL, true);
+}
+
+void input_remove(input_pin_t *pin) {
+    gpio_set_irq_enabled(pin->gpio, GPIO_IRQ_EDGE_RISE|GPIO_IRQ_EDGE_FALL, false);
+
+    const uint32_t irq=save_and_disable_interrupts();
+    input_pins[pin->gpio]=NULL;
+    restore_interrupts(irq);
+}
+
+bool input_get(input_event_t *e) {
+    return input_queue_pop(&input_queue, e);
+}
+
+bool input_wait(input_event_t *e, uint64_t until) {
+    for(;;) {
+        if(input_queue_pop(&input_queue, e))
+            return true;
+        if(time_us_64()>=until)
+            return false;
+
+        // woken by the SEV of the interrupt or any other event, the loop checks again
+        if(until==INPUT_NEVER)
+            __wfe();
+        else
+            best_effort_wfe_or_timeout(from_us_since_boot(until));
+    }
+}
+
+void input_flush(void) {
+    input_event_t e;
+    while(input_queue_pop(&input_queue, &e))
+        ;
+}
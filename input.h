@@ -0,0 +1,221 @@
+/**
+* @file input.h
+*
+* interrupt driven debounced buttons
+*
+* every edge of a registered pin raises a GPIO interrupt that timestamps it and feeds the pin's
+* debounce state machine. the machine reports a change at the first edge and then ignores the
+* bounce for debounce_us, so a press is seen without delay and a press shorter than any poll
+* interval is not lost; a level that differs from the reported one when the window ends is
+* reported then. a hardware alarm drives the window ends and the long-press and repeat times.
+*
+* events go to a single-producer/single-consumer ring: the interrupt handlers produce, the
+* application consumes with input_get, input_wait or from a sched task signalled on every event,
+* never polling the pins
+*
+* the state machine and the ring do not touch the hardware (input_debounce.c), host builds feed
+* them synthetic edge traces (tools/input_host)
+*/
+
+#ifndef _inc_input
+#define _inc_input
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "sched.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+*	@brief time a change is held before the pin is looked at again
+*/
+#ifndef INPUT_DEBOUNCE_US
+#define INPUT_DEBOUNCE_US 5000
+#endif
+
+/**
+*	@brief time held until INPUT_LONG, 0 for none
+*/
+#ifndef INPUT_LONG_US
+#define INPUT_LONG_US 800000
+#endif
+
+/**
+*	@brief interval of INPUT_REPEAT after INPUT_LONG, 0 for none
+*/
+#ifndef INPUT_REPEAT_US
+#define INPUT_REPEAT_US 200000
+#endif
+
+/**
+*	@brief events in the ring, power of 2
+*/
+#ifndef INPUT_QUEUE_SIZE
+#define INPUT_QUEUE_SIZE 16
+#endif
+
+/**
+*	@brief no deadline
+*/
+#define INPUT_NEVER UINT64_MAX
+
+/**
+*	@brief kind of event
+*/
+typedef enum {
+    INPUT_PRESS,
+    INPUT_RELEASE,
+    INPUT_LONG,
+    INPUT_REPEAT,
+} input_type_t;
+
+/**
+*	@brief button event
+*/
+typedef struct {
+    uint64_t time_us;	/**< time of the edge or the deadline that caused it */
+    uint32_t held_us;	/**< time since the press, 0 for INPUT_PRESS */
+    uint8_t gpio;		/**< pin */
+    uint8_t type;		/**< input_type_t */
+    uint16_t repeat;	/**< number of the INPUT_REPEAT since the press */
+} input_event_t;
+
+/**
+*	@brief single-producer/single-consumer ring of events
+*/
+typedef struct {
+    input_event_t events[INPUT_QUEUE_SIZE];
+    volatile uint32_t head;		/**< written by the producer */
+    volatile uint32_t tail;		/**< written by the consumer */
+    volatile uint32_t dropped;	/**< events lost to a full ring */
+} input_queue_t;
+
+/**
+*	@brief debounce state of a pin, owned by the caller (usually static)
+*/
+typedef struct {
+    uint8_t gpio;			/**< pin */
+    bool active_low;		/**< pressed when low, pull-up enabled by input_add */
+    bool level;				/**< pressed according to the last edge */
+    bool pressed;			/**< reported state */
+    uint16_t repeat;		/**< INPUT_REPEAT sent since the press */
+    uint32_t debounce_us;	/**< see INPUT_DEBOUNCE_US */
+    uint32_t long_us;		/**< see INPUT_LONG_US */
+    uint32_t repeat_us;		/**< see INPUT_REPEAT_US */
+    uint64_t edge;			/**< time of the last edge */
+    uint64_t settle;		/**< end of the debounce window, INPUT_NEVER outside one */
+    uint64_t since;			/**< time of the press */
+    uint64_t hold;			/**< next INPUT_LONG or INPUT_REPEAT, INPUT_NEVER if none */
+} input_pin_t;
+
+/**
+	@brief set up a pin's state machine with the default times, released
+
+	@param[in] pin : state
+	@param[in] gpio : pin number
+	@param[in] active_low : pressed when low
+*/
+void input_pin_init(input_pin_t *pin, uint8_t gpio, bool active_low);
+
+/**
+	@brief feed an edge to the state machine
+
+	@param[in] pin : state
+	@param[in] level : pin level after the edge
+	@param[in] now : time of the edge
+	@param[in] q : ring for the events
+
+	@return next deadline of the pin, see input_pin_timeout
+*/
+uint64_t input_pin_edge(input_pin_t *pin, bool level, uint64_t now, input_queue_t *q);
+
+/**
+	@brief advance the state machine to a time, emits the events due until then
+
+	@param[in] pin : state
+	@param[in] now : current time
+	@param[in] q : ring for the events
+
+	@return time input_pin_timeout has to be called again, INPUT_NEVER if no edge comes
+*/
+uint64_t input_pin_timeout(input_pin_t *pin, uint64_t now, input_queue_t *q);
+
+/**
+	@brief add an event, producer side
+
+	@param[in] q : ring
+	@param[in] e : event
+
+	@return false if the ring is full, the event is counted in q->dropped
+*/
+bool input_queue_push(input_queue_t *q, const input_event_t *e);
+
+/**
+	@brief take the oldest event, consumer side
+
+	@param[in] q : ring
+	@param[out] e : event
+
+	@return false if the ring is empty
+*/
+bool input_queue_pop(input_queue_t *q, input_event_t *e);
+
+/**
+	@brief install the interrupt handlers
+
+	takes the GPIO callback of the SDK (gpio_set_irq_callback), which is shared by all pins of
+	the core
+
+	@param[in] notify : task signalled with events on each new event, NULL for none
+	@param[in] events : event bits for notify
+*/
+void input_init(sched_task_t *notify, uint32_t events);
+
+/**
+	@brief register a pin: input, pull-up if active low, interrupts on both edges
+
+	the pin starts in the state it is read in, a button held at boot is reported when released
+
+	@param[in] pin : state set up by input_pin_init, times may be changed before
+*/
+void input_add(input_pin_t *pin);
+
+/**
+	@brief unregister a pin and disable its interrupts
+
+	@param[in] pin : state
+*/
+void input_remove(input_pin_t *pin);
+
+/**
+	@brief take the oldest event
+
+	@param[out] e : event
+
+	@return false if there is none
+*/
+bool input_get(input_event_t *e);
+
+/**
+	@brief sleep until an event arrives or a time is reached
+
+	@param[out] e : event
+	@param[in] until : absolute time in microseconds, INPUT_NEVER to wait forever
+
+	@return false on timeout
+*/
+bool input_wait(input_event_t *e, uint64_t until);
+
+/**
+	@brief drop the pending events
+*/
+void input_flush(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,119 @@
+/**
+* @file input_debounce.c
+*
+* debounce state machine and event ring of input.h, without hardware access
+*/
+
+#include "input.h"
+
+void input_pin_init(input_pin_t *pin, uint8_t gpio, bool active_low) {
+    pin->gpio=gpio;
+    pin->active_low=active_low;
+    pin->level=false;
+    pin->pressed=false;
+    pin->repeat=0;
+    pin->debounce_us=INPUT_DEBOUNCE_US;
+    pin->long_us=INPUT_LONG_US;
+    pin->repeat_us=INPUT_REPEAT_US;
+    pin->edge=0;
+    pin->settle=INPUT_NEVER;
+    pin->since=0;
+    pin->hold=INPUT_NEVER;
+}
+
+static void input_emit(input_pin_t *pin, input_type_t type, uint64_t time, input_queue_t *q) {
+    const input_event_t e= {
+        .time_us=time,
+        .held_us=type==INPUT_PRESS?0:time-pin->since,
+        .gpio=pin->gpio,
+        .type=type,
+        .repeat=pin->repeat,
+    };
+    input_queue_push(q, &e);
+}
+
+// report a change and open the debounce window
+static void input_commit(input_pin_t *pin, bool pressed, uint64_t time, input_queue_t *q) {
+    pin->pressed=pressed;
+    pin->settle=time+pin->debounce_us;
+
+    if(pressed) {
+        pin->since=time;
+        pin->repeat=0;
+        pin->hold=pin->long_us?time+pin->long_us:INPUT_NEVER;
+        input_emit(pin, INPUT_PRESS, time, q);
+    } else {
+        pin->hold=INPUT_NEVER;
+        input_emit(pin, INPUT_RELEASE, time, q);
+    }
+}
+
+inline static uint64_t input_next(const input_pin_t *pin) {
+    return pin->settle<pin->hold?pin->settle:pin->hold;
+}
+
+uint64_t input_pin_edge(input_pin_t *pin, bool level, uint64_t now, input_queue_t *q) {
+    input_pin_timeout(pin, now, q);
+
+    pin->level=level!=pin->active_low;
+    pin->edge=now;
+
+    // bounce inside the window is looked at when it ends
+    if(pin->settle==INPUT_NEVER && pin->level!=pin->pressed)
+        input_commit(pin, pin->level, now, q);
+
+    return input_next(pin);
+}
+
+uint64_t input_pin_timeout(input_pin_t *pin, uint64_t now, input_queue_t *q) {
+    if(pin->settle<=now) {
+        if(pin->level==pin->pressed)
+            pin->settle=INPUT_NEVER;
+        else if(pin->edge+pin->debounce_us<=now)
+            // the level differs and is quiet: the change the window hid, dated at its last edge
+            input_commit(pin, pin->level, pin->edge, q);
+        else
+            // still bouncing
+            pin->settle=pin->edge+pin->debounce_us;
+    }
+
+    while(pin->pressed && pin->hold<=now) {
+        const uint64_t time=pin->hold;
+        if(time==pin->since+pin->long_us && !pin->repeat) {
+            input_emit(pin, INPUT_LONG, time, q);
+        } else {
+            ++pin->repeat;
+            input_emit(pin, INPUT_REPEAT, time, q);
+        }
+        pin->hold=pin->repeat_us?time+pin->repeat_us:INPUT_NEVER;
+    }
+
+    return input_next(pin);
+}
+
+bool input_queue_push(input_queue_t *q, const input_event_t *e) {
+    const uint32_t head=q->head;
+    if(head-q->tail==INPUT_QUEUE_SIZE) {
+        ++q->dropped;
+        return false;
+    }
+
+    q->events[head&(INPUT_QUEUE_SIZE-1)]=*e;
+    // the event is written before the consumer sees the new head
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    q->head=head+1;
+    return true;
+}
+
+bool input_queue_pop(input_queue_t *q, input_event_t *e) {
+    const uint32_t tail=q->tail;
+    if(tail==q->head)
+        return false;
+
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    *e=q->events[tail&(INPUT_QUEUE_SIZE-1)];
+    // the slot is read before the producer may reuse it
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    q->tail=tail+1;
+    return true;
+}
@@ -0,0 +1,188 @@
+/**
+* @file joystick.c
+*
+* analog joystick conditioning, integer only
+*/
+
+#include "joystick.h"
+
+void joystick_init(joystick_t *j) {
+    *j=(joystick_t) {
+        .ema_shift=2,
+        .drift_shift=8,
+        .deadzone=80,
+        .dir_on=512,
+        .dir_off=256,
+        .curve=128,
+        .repeat_delay_us=400000,
+        .repeat_us=200000,
+        .repeat_min_us=40000,
+        .repeat_accel=200,
+    };
+}
+
+bool joystick_calibrated(const joystick_t *j) {
+    return j->samples>=JOYSTICK_CAL_SAMPLES;
+}
+
+inline static uint16_t joystick_median3(uint16_t a, uint16_t b, uint16_t c) {
+    if(a>b) {
+        const uint16_t t=a;
+        a=b;
+        b=t;
+    }
+    // a<=b: the median is b unless c is below it
+    return c>=b?b:c>a?c:a;
+}
+
+// median and EMA, the first sample fills the history
+static void joystick_filter(joystick_axis_t *a, uint16_t raw, bool first, uint8_t shift) {
+    if(raw>JOYSTICK_RAW_MAX)
+        raw=JOYSTICK_RAW_MAX;
+
+    if(first) {
+        a->window[0]=a->window[1]=a->window[2]=raw;
+        a->ema=(int32_t) raw<<8;
+        return;
+    }
+
+    a->window[0]=a->window[1];
+    a->window[1]=a->window[2];
+    a->window[2]=raw;
+    const int32_t m=(int32_t) joystick_median3(a->window[0], a->window[1], a->window[2])<<8;
+    a->ema+=(m-a->ema)/(1<<shift);
+}
+
+// rounded to nearest, so full travel reaches JOYSTICK_FULL despite the EMA residue; b>0
+inline static int32_t joystick_div(int32_t a, int32_t b) {
+    return (a>=0?a+b/2:a-b/2)/b;
+}
+
+inline static int32_t joystick_clamp(int32_t v) {
+    return v>JOYSTICK_FULL?JOYSTICK_FULL:v<-JOYSTICK_FULL?-JOYSTICK_FULL:v;
+}
+
+// start the extents three quarters of the way to the rails, they grow with use
+static void joystick_set_center(joystick_axis_t *a, uint32_t sum) {
+    a->center=(int32_t) ((sum<<8)/JOYSTICK_CAL_SAMPLES);
+    const int32_t c=a->center>>8;
+    a->min=c-c*3/4;
+    a->max=c+(JOYSTICK_RAW_MAX-c)*3/4;
+}
+
+// deflection against the extents of its side, -JOYSTICK_FULL..JOYSTICK_FULL
+static int32_t joystick_normalize(joystick_axis_t *a) {
+    const int32_t f=a->ema>>8;
+    if(f>a->max)
+        a->max=f;
+    if(f<a->min)
+        a->min=f;
+
+    const int32_t d=a->ema-a->center;
+    const int32_t span=d>=0?((int32_t) a->max<<8)-a->center:a->center-((int32_t) a->min<<8);
+    if(span<=0)
+        return 0;
+
+    // |d| < 2^20, the product stays in 31 bits
+    return joystick_clamp(joystick_div(d*JOYSTICK_FULL, span));
+}
+
+static uint32_t joystick_isqrt(uint32_t v) {
+    uint32_t r=0, bit=1u<<30;
+    while(bit>v)
+        bit>>=2;
+    while(bit) {
+        if(v>=r+bit) {
+            v-=r+bit;
+            r=(r>>1)+bit;
+        } else {
+            r>>=1;
+        }
+        bit>>=2;
+    }
+    return r;
+}
+
+// direction with hysteresis, the step bit when it starts
+static uint32_t joystick_direction(joystick_axis_t *a, uint32_t on, uint32_t off, uint32_t neg, uint32_t pos) {
+    if(a->dir && a->dir*a->value<(int32_t) off)
+        a->dir=0;
+    if(!a->dir) {
+        if(a->value>=(int32_t) on) {
+            a->dir=1;
+            return pos;
+        }
+        if(a->value<=-(int32_t) on) {
+            a->dir=-1;
+            return neg;
+        }
+    }
+    return 0;
+}
+
+inline static uint32_t joystick_held(const joystick_t *j) {
+    return (j->x.dir<0?JOYSTICK_LEFT:0)|(j->x.dir>0?JOYSTICK_RIGHT:0)|
+           (j->y.dir<0?JOYSTICK_DOWN:0)|(j->y.dir>0?JOYSTICK_UP:0);
+}
+
+uint32_t joystick_update(joystick_t *j, uint16_t raw_x, uint16_t raw_y, uint64_t now_us) {
+    const bool first=!j->samples;
+    joystick_filter(&j->x, raw_x, first, j->ema_shift);
+    joystick_filter(&j->y, raw_y, first, j->ema_shift);
+
+    if(!joystick_calibrated(j)) {
+        j->cal_sum_x+=j->x.ema>>8;
+        j->cal_sum_y+=j->y.ema>>8;
+        if(++j->samples==JOYSTICK_CAL_SAMPLES) {
+            joystick_set_center(&j->x, j->cal_sum_x);
+            joystick_set_center(&j->y, j->cal_sum_y);
+        }
+        return 0;
+    }
+
+    int32_t vx=joystick_normalize(&j->x), vy=joystick_normalize(&j->y);
+
+    // radial deadzone: the same threshold in every direction, the travel outside rescaled
+    const int32_t r=joystick_isqrt(vx*vx+vy*vy);
+    if(r<=j->deadzone) {
+        vx=vy=0;
+        // at rest: the center follows slow drift
+        j->x.center+=(j->x.ema-j->x.center)/(1<<j->drift_shift);
+        j->y.center+=(j->y.ema-j->y.center)/(1<<j->drift_shift);
+    } else {
+        const int32_t k=joystick_div((r-j->deadzone)*JOYSTICK_FULL, JOYSTICK_FULL-j->deadzone);
+        vx=joystick_clamp(joystick_div(vx*k, r));
+        vy=joystick_clamp(joystick_div(vy*k, r));
+    }
+    j->x.value=vx;
+    j->y.value=vy;
+
+    uint32_t steps=joystick_direction(&j->x, j->dir_on, j->dir_off, JOYSTICK_LEFT, JOYSTICK_RIGHT)|
+                   joystick_direction(&j->y, j->dir_on, j->dir_off, JOYSTICK_DOWN, JOYSTICK_UP);
+
+    // a new direction restarts the repeat, holding it repeats faster and faster
+    if(steps) {
+        j->interval=j->repeat_us;
+        j->next_repeat=now_us+j->repeat_delay_us;
+    } else if(j->repeat_delay_us && joystick_held(j) && now_us>=j->next_repeat) {
+        steps=joystick_held(j);
+        j->next_repeat+=j->interval;
+        if(j->next_repeat<=now_us)
+            j->next_repeat=now_us+j->interval;
+
+        j->interval=(uint64_t) j->interval*j->repeat_accel>>8;
+        if(j->interval<j->repeat_min_us)
+            j->interval=j->repeat_min_us;
+    }
+    return steps;
+}
+
+int32_t joystick_curve(const joystick_t *j, int32_t v) {
+    // v^3/FULL^2 keeps the sign and the full scale
+    const int32_t cube=v*v/JOYSTICK_FULL*v/JOYSTICK_FULL;
+    return v+(cube-v)*(int32_t) j->curve/256;
+}
+
+int32_t joystick_scale(int32_t v, int32_t lo, int32_t hi) {
+    return lo+(joystick_clamp(v)+JOYSTICK_FULL)*(hi-lo)/(2*JOYSTICK_FULL);
+}
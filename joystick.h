@@ -0,0 +1,145 @@
+/**
+* @file joystick.h
+*
+* analog joystick conditioning, integer only
+*
+* every sample of the two axes goes through: median of 3 (drops single spikes), exponential
+* moving average, normalization against the calibrated center and extents to
+* -JOYSTICK_FULL..JOYSTICK_FULL, and a radial deadzone that rescales the rest of the travel so
+* the output starts at 0 at its edge. the center is measured over the first samples after
+* joystick_init and then follows slow drift while the stick rests; the extents grow to the
+* largest deflection seen
+*
+* on top of the conditioned position: direction steps with hysteresis and auto-repeat that
+* speeds up while held, and a response curve for analog outputs (fine control near the center)
+*
+* no hardware access and no floating point: it runs per sample at kHz rates and builds on host
+*/
+
+#ifndef _inc_joystick
+#define _inc_joystick
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+*	@brief conditioned full deflection
+*/
+#define JOYSTICK_FULL 1024
+
+/**
+*	@brief largest raw sample (12 bit ADC)
+*/
+#define JOYSTICK_RAW_MAX 4095
+
+/**
+*	@brief samples averaged for the center after joystick_init
+*/
+#ifndef JOYSTICK_CAL_SAMPLES
+#define JOYSTICK_CAL_SAMPLES 32
+#endif
+
+/**
+*	@brief direction steps returned by joystick_update, one bit each
+*/
+enum {
+    JOYSTICK_UP=1,		/**< y positive */
+    JOYSTICK_DOWN=2,	/**< y negative */
+    JOYSTICK_LEFT=4,	/**< x negative */
+    JOYSTICK_RIGHT=8,	/**< x positive */
+};
+
+/**
+*	@brief state of one axis
+*/
+typedef struct {
+    uint16_t window[3];		/**< last raw samples for the median */
+    int32_t ema;			/**< filtered raw value, Q8 */
+    int32_t center;			/**< calibrated center, Q8 */
+    uint16_t min;			/**< smallest filtered value seen */
+    uint16_t max;			/**< largest filtered value seen */
+    int16_t value;			/**< conditioned position, -JOYSTICK_FULL..JOYSTICK_FULL */
+    int8_t dir;				/**< direction with hysteresis: -1, 0, 1 */
+} joystick_axis_t;
+
+/**
+*	@brief joystick, the parameters may be changed after joystick_init
+*/
+typedef struct {
+    joystick_axis_t x;
+    joystick_axis_t y;
+    uint8_t ema_shift;			/**< EMA weight of a new sample is 1/2^ema_shift */
+    uint8_t drift_shift;		/**< center follows a resting stick with weight 1/2^drift_shift */
+    uint16_t deadzone;			/**< radius of the deadzone, conditioned units */
+    uint16_t dir_on;			/**< deflection that starts a direction */
+    uint16_t dir_off;			/**< deflection below which it ends, less than dir_on */
+    uint16_t curve;				/**< share of cubic in the response curve, 0 (linear) to 256 */
+    uint32_t repeat_delay_us;	/**< first auto-repeat after the step, 0 for none */
+    uint32_t repeat_us;			/**< first repeat interval */
+    uint32_t repeat_min_us;		/**< fastest repeat interval */
+    uint16_t repeat_accel;		/**< interval kept per repeat, /256 */
+    uint16_t samples;			/**< samples seen, calibration ends at JOYSTICK_CAL_SAMPLES */
+    uint32_t cal_sum_x;			/**< sums for the center calibration */
+    uint32_t cal_sum_y;
+    uint32_t interval;			/**< current repeat interval */
+    uint64_t next_repeat;		/**< time of the next repeat */
+} joystick_t;
+
+/**
+	@brief set up a joystick with default parameters, calibration starts with the next sample
+
+	the stick should rest during the first JOYSTICK_CAL_SAMPLES samples
+
+	@param[in] j : joystick
+*/
+void joystick_init(joystick_t *j);
+
+/**
+	@brief feed one sample of both axes
+
+	@param[in] j : joystick
+	@param[in] raw_x : raw x, 0..JOYSTICK_RAW_MAX
+	@param[in] raw_y : raw y, 0..JOYSTICK_RAW_MAX
+	@param[in] now_us : time of the sample, for the auto-repeat
+
+	@return direction steps (JOYSTICK_UP...) started or repeated by this sample
+*/
+uint32_t joystick_update(joystick_t *j, uint16_t raw_x, uint16_t raw_y, uint64_t now_us);
+
+/**
+	@brief whether the center calibration is done
+
+	@param[in] j : joystick
+*/
+bool joystick_calibrated(const joystick_t *j);
+
+/**
+	@brief apply the response curve
+
+	@param[in] j : joystick
+	@param[in] v : conditioned position, e.g. j->x.value
+
+	@return curved position, same range and sign
+*/
+int32_t joystick_curve(const joystick_t *j, int32_t v);
+
+/**
+	@brief map a position to an output range
+
+	@param[in] v : position, -JOYSTICK_FULL..JOYSTICK_FULL
+	@param[in] lo : output at -JOYSTICK_FULL
+	@param[in] hi : output at JOYSTICK_FULL
+
+	@return lo..hi
+*/
+int32_t joystick_scale(int32_t v, int32_t lo, int32_t hi);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
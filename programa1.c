@@ -1,15 +1,14 @@
 #include <stdio.h>
-#include "hardware/adc.h"
 #include "hardware/pwm.h"
 #include "pico/stdlib.h"
 #include "programa1.h"
+#include "adc_service.h"
+#include "joystick.h"
 
 // Definição dos pinos usados para o joystick e LEDs
-const int VRX = 26;          // Eixo X do joystick
-const int VRY = 27;          // Eixo Y do joystick
-const int ADC_CHANNEL_0 = 0; // Canal ADC para o eixo X
-const int ADC_CHANNEL_1 = 1; // Canal ADC para o eixo Y
-const int SW = 22;           // Pino do botão do joystick
+const int ADC_CHANNEL_0 = 0; // Canal ADC para o eixo X (GPIO 26)
+const int ADC_CHANNEL_1 = 1; // Canal ADC para o eixo Y (GPIO 27)
+const int OVERSAMPLE = 2;    // Média de 2^2 amostras por leitura
 
 const int LED_B = 13;        // Pino para o LED azul via PWM
 const int LED_R = 11;        // Pino para o LED vermelho via PWM
@@ -17,17 +16,14 @@ static const float DIVIDER_PWM = 16.0;
 static const uint16_t PERIOD = 4096;
 uint16_t led_b_level = 100, led_r_level = 100;
 uint slice_led_b, slice_led_r;
+static sched_task_t joystick_task; // Tarefa que atualiza os LEDs
+static joystick_t stick;           // Posição calibrada, filtrada e com zona morta
 
-// Função para configurar o ADC e o pino do botão do joystick
+// Função para registrar os eixos do joystick no serviço de ADC (o botão é tratado pelo menu)
 void setup_joystick(void)
 {
-    adc_init();          // Inicializa o ADC
-    adc_gpio_init(VRX);  // Configura o pino do eixo X para ADC
-    adc_gpio_init(VRY);  // Configura o pino do eixo Y para ADC
-
-    gpio_init(SW);                   // Inicializa o pino do botão
-    gpio_set_dir(SW, GPIO_IN);       // Define o pino como entrada
-    gpio_pull_up(SW);                // Ativa pull-up para estabilidade
+    adc_service_add(ADC_CHANNEL_0, OVERSAMPLE);  // Eixo X amostrado continuamente
+    adc_service_add(ADC_CHANNEL_1, OVERSAMPLE);  // Eixo Y amostrado continuamente
 }
 
 // Função para configurar o PWM para um LED (genérica)
@@ -45,49 +41,46 @@ void setup_pwm_led(uint led, uint *slice, uint16_t level)
 void joystick_setup(void)
 {
     stdio_init_all();           // Inicializa a porta serial, se necessário
-    setup_joystick();           // Configura o ADC e o botão
+    setup_joystick();           // Registra os eixos no serviço de ADC
     setup_pwm_led(LED_B, &slice_led_b, led_b_level); // Configura o LED azul
     setup_pwm_led(LED_R, &slice_led_r, led_r_level); // Configura o LED vermelho
 }
 
-// Função para ler os valores dos eixos do joystick
+// Função para ler os valores dos eixos do joystick: os mais recentes do serviço, sem esperar
 void joystick_read_axis(uint16_t *vrx_value, uint16_t *vry_value)
 {
-    // Leitura do eixo X
-    adc_select_input(ADC_CHANNEL_0);
-    sleep_us(2);
-    *vrx_value = adc_read();
-
-    // Leitura do eixo Y
-    adc_select_input(ADC_CHANNEL_1);
-    sleep_us(2);
-    *vry_value = adc_read();
+    *vrx_value = adc_service_read(ADC_CHANNEL_0);
+    *vry_value = adc_service_read(ADC_CHANNEL_1);
 }
 
-// Função que executa o programa do joystick
-void joystickProgram(void)
+// Tarefa periódica: ajusta o PWM dos LEDs de acordo com a posição do joystick.
+// Com o joystick solto os LEDs ficam na metade; a curva dá controle fino perto do centro.
+static void joystick_task_fn(sched_task_t *t)
 {
+    (void) t;
     uint16_t vrx_value, vry_value;
+    joystick_read_axis(&vrx_value, &vry_value);
+    joystick_update(&stick, vrx_value, vry_value, sched_now());
+    pwm_set_gpio_level(LED_B, joystick_scale(joystick_curve(&stick, stick.x.value), 0, PERIOD));
+    pwm_set_gpio_level(LED_R, joystick_scale(joystick_curve(&stick, stick.y.value), 0, PERIOD));
+}
+
+// Inicia o programa do joystick: leitura a cada 20 ms, sem bloquear a CPU
+void joystickProgramStart(sched_task_t *owner)
+{
+    (void) owner;
     // Configura os periféricos do joystick e LEDs
     joystick_setup();
     printf("Joystick-PWM\n");
 
-    // Loop principal do programa do joystick
-    while (1)
-    {
-        joystick_read_axis(&vrx_value, &vry_value);
-        // Ajusta o PWM dos LEDs de acordo com os valores do joystick
-        pwm_set_gpio_level(LED_B, vrx_value);
-        pwm_set_gpio_level(LED_R, vry_value);
-        sleep_ms(100);
+    // O centro é medido nas primeiras leituras
+    joystick_init(&stick);
+    sched_add(&joystick_task, "joystick", joystick_task_fn, NULL);
+    sched_every(&joystick_task, 20 * 1000);
+}
 
-        // Exemplo: se o botão for pressionado, saia do programa do joystick
-        // (ou use outra condição para retornar ao menu)
-        if (gpio_get(SW) == 0)
-        {
-            // Aguarda o "debounce" e sai do loop
-            sleep_ms(300);
-            break;
-        }
-    }
-}
\ No newline at end of file
+// Encerra o programa do joystick (o botão é tratado pelo menu)
+void joystickProgramStop(void)
+{
+    sched_remove(&joystick_task);
+}
@@ -2,8 +2,13 @@
 #ifndef PROGRAMA1_H
 #define PROGRAMA1_H
 
+#include "sched.h"
 
-// Declaração da função que será implementada no arquivo programa1.c
-void joystickProgram(void);
+// Inicia o programa do joystick como tarefa do escalonador.
+// O programa roda até joystickProgramStop; owner não é sinalizado.
+void joystickProgramStart(sched_task_t *owner);
+
+// Encerra o programa do joystick
+void joystickProgramStop(void);
 
 #endif // PROGRAMA1_H
\ No newline at end of file
@@ -2,7 +2,13 @@
 #ifndef PROGRAMA2_H
 #define PROGRAMA2_H
 
-// Declara a função que executa o programa do Buzzer
-void buzzerProgram(void);
+#include "sched.h"
+
+// Inicia o programa do Buzzer como tarefa do escalonador.
+// Ao fim da música, owner recebe SCHED_EVENT_DONE.
+void buzzerProgramStart(sched_task_t *owner);
+
+// Interrompe a música
+void buzzerProgramStop(void);
 
 #endif // PROGRAMA2_H
\ No newline at end of file
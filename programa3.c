@@ -4,30 +4,13 @@
 #include "programa3.h"
 
 #define LED 12      // Pino do LED (pode ser o canal de um LED RGB)
-#define SW 22       // Pino do botão do joystick (usado para interromper o programa)
 
 static const uint16_t PERIOD = 2000;     // Período do PWM (valor máximo do contador)
 static const float DIVIDER_PWM = 16.0;     // Divisor do clock para o PWM
 const uint16_t LED_STEP = 100;             // Passo de incremento/decremento para o duty cycle do LED
 static uint16_t led_level = 100;           // Nível inicial do PWM (duty cycle)
-
-// Função que verifica periodicamente se o botão foi pressionado durante um atraso.
-// Retorna true se o botão for pressionado.
-static bool checkButtonDuringDelay(uint delay_ms) {
-    const uint step = 50;  // Intervalo de verificação (50 ms)
-    uint elapsed = 0;
-    while (elapsed < delay_ms) {
-        if (gpio_get(SW) == 0) {
-            sleep_ms(50); // debounce
-            if (gpio_get(SW) == 0) {
-                return true; // Botão pressionado
-            }
-        }
-        sleep_ms(step);
-        elapsed += step;
-    }
-    return false;
-}
+static uint up_down = 1;                   // Controle para aumentar ou diminuir o duty cycle
+static sched_task_t led_task;              // Tarefa que muda o brilho do LED
 
 // Configura o PWM para o LED
 static void setup_pwm() {
@@ -39,41 +22,34 @@ static void setup_pwm() {
     pwm_set_enabled(slice, true);
 }
 
-// Função que executa o programa do LED RGB.
-// Se o botão (SW) for pressionado, o programa é interrompido e retorna ao menu.
-void ledRgbProgram(void) {
+// Tarefa periódica: atualiza o nível do LED conforme a direção
+static void led_task_fn(sched_task_t *t) {
+    (void) t;
+    if (up_down) {
+        led_level += LED_STEP;
+        if (led_level >= PERIOD)
+            up_down = 0;
+    } else {
+        led_level -= LED_STEP;
+        if (led_level <= LED_STEP)
+            up_down = 1;
+    }
+    pwm_set_gpio_level(LED, led_level);
+}
+
+// Inicia o programa do LED RGB: um passo de brilho por segundo, sem bloquear a CPU
+void ledRgbProgramStart(sched_task_t *owner) {
+    (void) owner;
     printf("LED RGB Program started.\n");
     setup_pwm();
-    uint up_down = 1;  // Controle para aumentar ou diminuir o duty cycle
-
-    while (true) {
-        // Atualiza o nível de PWM para o LED
-        pwm_set_gpio_level(LED, led_level);
-
-        // Verifica imediatamente se o botão foi pressionado
-        if (gpio_get(SW) == 0) {
-            sleep_ms(50); // debounce
-            if (gpio_get(SW) == 0) {
-                printf("LED RGB Program interrupted.\n");
-                break;
-            }
-        }
+    up_down = 1;
 
-        // Em vez de um atraso único de 1000 ms, dividimos em intervalos curtos
-        if (checkButtonDuringDelay(1000)) {
-            printf("LED RGB Program interrupted during delay.\n");
-            break;
-        }
+    sched_add(&led_task, "led", led_task_fn, NULL);
+    sched_every(&led_task, 1000 * 1000);
+}
 
-        // Atualiza o nível do LED conforme a direção
-        if (up_down) {
-            led_level += LED_STEP;
-            if (led_level >= PERIOD)
-                up_down = 0;
-        } else {
-            led_level -= LED_STEP;
-            if (led_level <= LED_STEP)
-                up_down = 1;
-        }
-    }
+// Encerra o programa do LED RGB (o botão é tratado pelo menu)
+void ledRgbProgramStop(void) {
+    sched_remove(&led_task);
+    printf("LED RGB Program interrupted.\n");
 }
@@ -2,7 +2,13 @@
 #ifndef PROGRAMA3_H
 #define PROGRAMA3_H
 
-// Declara a função que executa o programa do LED RGB
-void ledRgbProgram(void);
+#include "sched.h"
+
+// Inicia o programa do LED RGB como tarefa do escalonador.
+// O programa roda até ledRgbProgramStop; owner não é sinalizado.
+void ledRgbProgramStart(sched_task_t *owner);
+
+// Encerra o programa do LED RGB
+void ledRgbProgramStop(void);
 
 #endif // PROGRAMA3_H
\ No newline at end of file
@@ -0,0 +1,63 @@
+/**
+* @file pwm_freq.c
+*
+* exact PWM frequency synthesis
+*/
+
+#include <pico/stdlib.h>
+#include <hardware/pwm.h>
+
+#include "pwm_freq.h"
+
+// the search of pwm_freq.hpp is the same, keep both in step
+
+pwm_freq_t pwm_freq_solve(uint32_t clk_hz, uint32_t freq_mhz) {
+    if(!freq_mhz)
+        freq_mhz=1;
+
+    // period in sixteenths of a clock, Q8: the target of div*(wrap+1)
+    const uint64_t n=(uint64_t) clk_hz*16000;
+    const uint64_t target=(n<<8)/freq_mhz;
+    if(target>>8>=(uint64_t) PWM_FREQ_DIV_MAX*PWM_FREQ_PERIOD_MAX)
+        return (pwm_freq_t) {PWM_FREQ_DIV_MAX, PWM_FREQ_PERIOD_MAX-1};
+
+    const uint32_t t=(uint32_t) (target>>8), frac=(uint32_t) target&255;
+    uint32_t d=(t+PWM_FREQ_PERIOD_MAX-1)/PWM_FREQ_PERIOD_MAX;
+    if(d<PWM_FREQ_DIV_MIN)
+        d=PWM_FREQ_DIV_MIN;
+
+    pwm_freq_t best= {PWM_FREQ_DIV_MIN, 0};
+    uint32_t best_err=0, best_period=0;
+    for(; d<=PWM_FREQ_DIV_MAX; ++d) {
+        // the periods just below and just above the target, errors in 1/256 of a count
+        const uint32_t w0=t/d, rem=t-w0*d;
+        const uint32_t w[2]= {w0, w0+1}, err[2]= {rem*256+frac, (d-rem)*256-frac};
+        for(uint32_t k=0; k<2; ++k) {
+            if(!w[k] || w[k]>PWM_FREQ_PERIOD_MAX)
+                continue;
+
+            // relative errors err/period, compared without dividing
+            const uint32_t period=d*w[k];
+            if(!best_period || (uint64_t) err[k]*best_period<(uint64_t) best_err*period) {
+                best_err=err[k];
+                best_period=period;
+                best=(pwm_freq_t) {(uint16_t) d, (uint16_t) (w[k]-1)};
+            }
+        }
+        if(!best_err)
+            break;
+    }
+    return best;
+}
+
+uint32_t pwm_freq_mhz(uint32_t clk_hz, pwm_freq_t f) {
+    const uint64_t period=(uint64_t) f.div*((uint32_t) f.top+1);
+    return (uint32_t) (((uint64_t) clk_hz*16000+period/2)/period);
+}
+
+void pwm_freq_apply(uint32_t gpio, pwm_freq_t f) {
+    const uint slice=pwm_gpio_to_slice_num(gpio);
+    pwm_hw->slice[slice].div=f.div;
+    pwm_hw->slice[slice].top=f.top;
+    pwm_set_gpio_level(gpio, ((uint32_t) f.top+1)>>1);
+}
@@ -0,0 +1,90 @@
+/**
+* @file pwm_freq.h
+*
+* exact PWM frequency synthesis
+*
+* a PWM slice counts clk_sys divided by an 8.4 fixed point divider (1 to 255 15/16) from 0 to
+* its wrap, so its frequency is 16*clk_sys/(div*(wrap+1)) with div in sixteenths. the solver
+* tries every divider and rounds the wrap for it, and keeps the pair with the smallest frequency
+* error; among equal errors the largest wrap (finest duty resolution) wins. the result is kept
+* as register values, so a frequency change writes DIV and TOP, with no division and no
+* floating point
+*
+* solving takes a few milliseconds, do it once: at start up, or at compile time with the C++17
+* generator of pwm_freq.hpp, which puts whole note tables in flash
+*
+*   pwm_freq_t a4=pwm_freq_solve(clock_get_hz(clk_sys), 440000);
+*   pwm_freq_apply(pin, a4);
+*/
+
+#ifndef _inc_pwm_freq
+#define _inc_pwm_freq
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+*	@brief smallest and largest divider in sixteenths
+*/
+#define PWM_FREQ_DIV_MIN 16
+#define PWM_FREQ_DIV_MAX 4095
+
+/**
+*	@brief largest period in counts (wrap+1)
+*/
+#define PWM_FREQ_PERIOD_MAX 65536
+
+/**
+*	@brief 2^(k/12) in Q16 for k=0..11, the semitones of an octave; initializer of the MIDI note
+*	frequencies of tone.c and pwm_freq.hpp
+*/
+#define PWM_FREQ_SEMITONE_Q16 { \
+    65536, 69433, 73562, 77936, 82570, 87480, 92682, 98193, 104032, 110218, 116772, 123715, \
+}
+
+/**
+*	@brief register values of a frequency
+*/
+typedef struct {
+    uint16_t div;	/**< DIV register: integer part in bits 11:4, sixteenths in 3:0 */
+    uint16_t top;	/**< TOP register: wrap, the period is top+1 counts */
+} pwm_freq_t;
+
+/**
+	@brief divider and wrap closest to a frequency
+
+	frequencies out of reach give the fastest or slowest setting
+
+	@param[in] clk_hz : clock of the slice, clock_get_hz(clk_sys)
+	@param[in] freq_mhz : frequency in millihertz, not 0
+
+	@return register values
+*/
+pwm_freq_t pwm_freq_solve(uint32_t clk_hz, uint32_t freq_mhz);
+
+/**
+	@brief frequency of register values
+
+	@param[in] clk_hz : clock of the slice
+	@param[in] f : register values
+
+	@return frequency in millihertz, rounded
+*/
+uint32_t pwm_freq_mhz(uint32_t clk_hz, pwm_freq_t f);
+
+/**
+	@brief set the frequency of the slice of a pin and a 50% duty on the pin
+
+	@param[in] gpio : PWM pin
+	@param[in] f : register values
+*/
+void pwm_freq_apply(uint32_t gpio, pwm_freq_t f);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
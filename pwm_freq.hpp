@@ -0,0 +1,124 @@
+/**
+* @file pwm_freq.hpp
+*
+* C++17 compile-time front end of pwm_freq: the same search as pwm_freq_solve as constexpr, and
+* table generators, so note tables are divider and wrap pairs in flash
+*
+*   constexpr auto &beeps=pwm_freq_table<125000000, 100000, 320000>;
+*   static_assert(pwm_freq_error_ppm(125000000, 100000, beeps[0])<10, "beep out of tune");
+*   pwm_freq_apply(pin, beeps[1]);
+*
+* the clock is a compile-time constant: compare it with clock_get_hz(clk_sys) before using a
+* table, see tone.c. the search is exhaustive, every value costs the compiler tens of
+* milliseconds
+*/
+
+#ifndef _inc_pwm_freq_hpp
+#define _inc_pwm_freq_hpp
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "pwm_freq.h"
+
+/**
+	@brief divider and wrap closest to a frequency, compile-time pwm_freq_solve
+
+	@param[in] clk_hz : clock of the slice
+	@param[in] freq_mhz : frequency in millihertz, not 0
+
+	@return register values, the same as pwm_freq_solve
+*/
+constexpr pwm_freq_t pwm_freq_solve_cx(uint32_t clk_hz, uint32_t freq_mhz) {
+    if(!freq_mhz)
+        freq_mhz=1;
+
+    const uint64_t n=(uint64_t) clk_hz*16000;
+    const uint64_t target=(n<<8)/freq_mhz;
+    if(target>>8>=(uint64_t) PWM_FREQ_DIV_MAX*PWM_FREQ_PERIOD_MAX)
+        return pwm_freq_t {PWM_FREQ_DIV_MAX, PWM_FREQ_PERIOD_MAX-1};
+
+    const uint32_t t=(uint32_t) (target>>8), frac=(uint32_t) target&255;
+    uint32_t d=(t+PWM_FREQ_PERIOD_MAX-1)/PWM_FREQ_PERIOD_MAX;
+    if(d<PWM_FREQ_DIV_MIN)
+        d=PWM_FREQ_DIV_MIN;
+
+    pwm_freq_t best {PWM_FREQ_DIV_MIN, 0};
+    uint32_t best_err=0, best_period=0;
+    for(; d<=PWM_FREQ_DIV_MAX; ++d) {
+        // the periods just below and just above the target, errors in 1/256 of a count
+        const uint32_t w0=t/d, rem=t-w0*d;
+        const uint32_t w[2]= {w0, w0+1}, err[2]= {rem*256+frac, (d-rem)*256-frac};
+        for(uint32_t k=0; k<2; ++k) {
+            if(!w[k] || w[k]>PWM_FREQ_PERIOD_MAX)
+                continue;
+
+            // relative errors err/period, compared without dividing
+            const uint32_t period=d*w[k];
+            if(!best_period || (uint64_t) err[k]*best_period<(uint64_t) best_err*period) {
+                best_err=err[k];
+                best_period=period;
+                best=pwm_freq_t {(uint16_t) d, (uint16_t) (w[k]-1)};
+            }
+        }
+        if(!best_err)
+            break;
+    }
+    return best;
+}
+
+/**
+	@brief frequency error of register values in parts per million, for static_assert
+
+	@param[in] clk_hz : clock of the slice
+	@param[in] freq_mhz : wanted frequency in millihertz
+	@param[in] f : register values
+*/
+constexpr uint32_t pwm_freq_error_ppm(uint32_t clk_hz, uint32_t freq_mhz, pwm_freq_t f) {
+    const uint64_t period=(uint64_t) f.div*((uint32_t) f.top+1);
+    const uint64_t n=(uint64_t) clk_hz*16000, want=(uint64_t) freq_mhz*period;
+    // |n/period-freq|/freq
+    return (uint32_t) ((n>want?n-want:want-n)*1000000/want);
+}
+
+/**
+	@brief frequency of a MIDI note in millihertz, the same as tone_midi_mhz
+
+	@param[in] midi : note number, 69 is A4 at 440 Hz
+*/
+constexpr uint32_t pwm_freq_midi_mhz(uint8_t midi) {
+    constexpr uint32_t ratio[12]=PWM_FREQ_SEMITONE_Q16;
+    const int32_t n=(int32_t) midi-69+12*11;
+    const int32_t octave=n/12-11;
+    const uint64_t f=440000ull*ratio[n%12];
+    const uint64_t g=octave>=0?f<<octave:f>>-octave;
+    return (uint32_t) ((g+(1u<<15))>>16);
+}
+
+/**
+*	@brief register values of one frequency, a constant of its own: the compile-time cost of a
+*	solve is counted per constant, a table solved in one expression would hit the limits
+*/
+template<uint32_t ClkHz, uint32_t FreqMhz>
+inline constexpr pwm_freq_t pwm_freq_v=pwm_freq_solve_cx(ClkHz, FreqMhz);
+
+/**
+*	@brief table of register values, one per frequency in millihertz
+*/
+template<uint32_t ClkHz, uint32_t... FreqMhz>
+inline constexpr std::array<pwm_freq_t, sizeof...(FreqMhz)> pwm_freq_table= {pwm_freq_v<ClkHz, FreqMhz>...};
+
+template<uint32_t ClkHz, uint8_t First, size_t... I>
+constexpr std::array<pwm_freq_t, sizeof...(I)> pwm_freq_midi_table_of(std::index_sequence<I...>) {
+    return {pwm_freq_v<ClkHz, pwm_freq_midi_mhz((uint8_t) (First+I))>...};
+}
+
+/**
+*	@brief table of register values of the MIDI notes First..First+N-1
+*/
+template<uint32_t ClkHz, uint8_t First, size_t N>
+inline constexpr std::array<pwm_freq_t, N> pwm_freq_midi_table=pwm_freq_midi_table_of<ClkHz, First>(std::make_index_sequence<N>());
+
+#endif
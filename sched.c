@@ -0,0 +1,203 @@
+/**
+* @file sched.c
+*
+* cooperative tick-less scheduler
+*/
+
+#include <stdio.h>
+#include <pico/stdlib.h>
+#include <hardware/sync.h>
+
+#include "sched.h"
+
+static uint64_t sched_alarm_now(void) {
+    return time_us_64();
+}
+
+// WFE ends on the alarm pool's hardware alarm or on the SEV of sched_signal
+static void sched_alarm_idle(uint64_t until) {
+    if(until==SCHED_NEVER)
+        __wfe();
+    else
+        best_effort_wfe_or_timeout(from_us_since_boot(until));
+}
+
+const sched_clock_t sched_alarm_clock= {
+    .now=sched_alarm_now,
+    .idle=sched_alarm_idle,
+};
+
+static const sched_clock_t *sched_clock=&sched_alarm_clock;
+static sched_task_t *sched_tasks;
+
+void sched_init(const sched_clock_t *clock) {
+    sched_clock=clock?clock:&sched_alarm_clock;
+    sched_tasks=NULL;
+}
+
+uint64_t sched_now(void) {
+    return sched_clock->now();
+}
+
+// unlinks t if registered, t->next stays valid for a run loop standing on t
+static void sched_unlink(sched_task_t *t) {
+    for(sched_task_t **l=&sched_tasks; *l; l=&(*l)->next) {
+        if(*l==t) {
+            *l=t->next;
+            return;
+        }
+    }
+}
+
+void sched_add(sched_task_t *t, const char *name, sched_fn_t fn, void *arg) {
+    sched_unlink(t);
+
+    t->fn=fn;
+    t->arg=arg;
+    t->name=name;
+    t->due=SCHED_NEVER;
+    t->period_us=0;
+    t->wait_mask=0;
+    t->events=0;
+    t->fired=0;
+    t->expired=false;
+    t->signalled=0;
+    t->runs=0;
+    t->latency_us_max=0;
+    t->latency_us_total=0;
+    t->next=NULL;
+
+    // tasks due at the same time run in the order they were added
+    sched_task_t **l=&sched_tasks;
+    while(*l)
+        l=&(*l)->next;
+    *l=t;
+}
+
+void sched_remove(sched_task_t *t) {
+    sched_unlink(t);
+}
+
+void sched_after(sched_task_t *t, uint32_t us) {
+    t->period_us=0;
+    t->due=sched_clock->now()+us;
+}
+
+void sched_every(sched_task_t *t, uint32_t period_us) {
+    t->period_us=period_us;
+    t->due=sched_clock->now()+period_us;
+}
+
+void sched_cancel(sched_task_t *t) {
+    t->period_us=0;
+    t->due=SCHED_NEVER;
+}
+
+void sched_wait(sched_task_t *t, uint32_t mask) {
+    t->wait_mask=mask;
+}
+
+void sched_signal(sched_task_t *t, uint32_t events) {
+    const uint64_t now=sched_clock->now();
+
+    const uint32_t irq=save_and_disable_interrupts();
+    if(!(t->events&t->wait_mask))
+        t->signalled=now;
+    t->events|=events;
+    restore_interrupts(irq);
+
+    // wakes sched_alarm_idle
+    __sev();
+}
+
+// consumes the waited-for events of t
+static uint32_t sched_take(sched_task_t *t) {
+    if(!(t->events&t->wait_mask))
+        return 0;
+
+    const uint32_t irq=save_and_disable_interrupts();
+    const uint32_t fired=t->events&t->wait_mask;
+    t->events&=~fired;
+    restore_interrupts(irq);
+    return fired;
+}
+
+bool sched_run_once(void) {
+    bool ran=false;
+
+    for(sched_task_t *t=sched_tasks; t; t=t->next) {
+        const uint64_t now=sched_clock->now();
+        const bool expired=t->due<=now;
+        const uint64_t signalled=t->signalled;
+        const uint32_t fired=sched_take(t);
+        if(!expired && !fired)
+            continue;
+
+        // ready since the timer expired or the first event arrived, whichever was first
+        uint64_t ready=expired?t->due:now;
+        if(fired && signalled<ready)
+            ready=signalled;
+
+        if(expired) {
+            if(!t->period_us)
+                t->due=SCHED_NEVER;
+            else if((t->due+=t->period_us)<=now)
+                t->due+=((now-t->due)/t->period_us+1)*t->period_us;
+        }
+
+        const uint32_t latency=now-ready;
+        if(latency>t->latency_us_max)
+            t->latency_us_max=latency;
+        t->latency_us_total+=latency;
+        ++t->runs;
+
+        t->fired=fired;
+        t->expired=expired;
+        t->fn(t);
+        ran=true;
+    }
+
+    return ran;
+}
+
+// earliest time a task becomes ready, 0 if one is already
+static uint64_t sched_next_due(void) {
+    uint64_t due=SCHED_NEVER;
+    for(sched_task_t *t=sched_tasks; t; t=t->next) {
+        if(t->events&t->wait_mask)
+            return 0;
+        if(t->due<due)
+            due=t->due;
+    }
+    return due;
+}
+
+void sched_run_until(volatile bool *stop) {
+    while(!stop || !*stop) {
+        if(!sched_run_once())
+            sched_clock->idle(sched_next_due());
+    }
+}
+
+void sched_run_for(uint64_t us) {
+    const uint64_t end=sched_clock->now()+us;
+
+    while(sched_clock->now()<end) {
+        if(sched_run_once())
+            continue;
+
+        const uint64_t due=sched_next_due();
+        sched_clock->idle(due<end?due:end);
+    }
+}
+
+void sched_run(void) {
+    sched_run_until(NULL);
+}
+
+void sched_dump(const char *name) {
+    for(sched_task_t *t=sched_tasks; t; t=t->next)
+        printf("[%s] %s: %lu runs, latency avg %lu us, max %lu us\n", name, t->name?t->name:"?",
+               (unsigned long) t->runs, (unsigned long) (t->runs?t->latency_us_total/t->runs:0),
+               (unsigned long) t->latency_us_max);
+}
@@ -0,0 +1,196 @@
+/**
+* @file sched.h
+*
+* cooperative tick-less scheduler
+*
+* a task is a function that runs to completion when its timer expires or one of the events
+* it waits for is signalled; longer jobs keep their state in the task and return, arming the
+* timer for the next step instead of sleeping. between runs the CPU sleeps (WFE) until the
+* earliest timer, woken by a hardware alarm or by sched_signal from an interrupt. there is no
+* periodic tick: nothing runs while no timer expires
+*
+* time comes from a sched_clock_t: the hardware timer by default, a virtual clock on host
+* builds (tools/sched_host) so latency and jitter can be measured without a board
+*/
+
+#ifndef _inc_sched
+#define _inc_sched
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+*	@brief timer value of a task without timer
+*/
+#define SCHED_NEVER UINT64_MAX
+
+/**
+*	@brief event sent by convention to the owner of a job that finished by itself
+*/
+#define SCHED_EVENT_DONE (1u<<31)
+
+struct sched_task;
+
+/**
+*	@brief task function
+*
+*	@param[in] t : the task, t->fired and t->expired tell why it runs
+*/
+typedef void (*sched_fn_t)(struct sched_task *t);
+
+/**
+*	@brief time source
+*/
+typedef struct {
+    /** current time in microseconds */
+    uint64_t (*now)(void);
+    /** sleep until the time (SCHED_NEVER: no timer) or until sched_signal, may return early */
+    void (*idle)(uint64_t until);
+} sched_clock_t;
+
+/**
+*	@brief default clock: time_us_64, WFE woken by a hardware alarm
+*/
+extern const sched_clock_t sched_alarm_clock;
+
+/**
+*	@brief task, owned by the caller (usually static), registered with sched_add
+*/
+typedef struct sched_task {
+    sched_fn_t fn;				/**< task function */
+    void *arg;					/**< user argument */
+    const char *name;			/**< name for sched_dump */
+    uint64_t due;				/**< time the timer expires, SCHED_NEVER if not armed */
+    uint32_t period_us;			/**< interval of a periodic timer, 0 for one-shot */
+    uint32_t wait_mask;			/**< events that make the task run */
+    volatile uint32_t events;	/**< signalled events not consumed yet */
+    uint32_t fired;				/**< events of wait_mask consumed by the current run */
+    bool expired;				/**< the current run was started by the timer */
+    uint64_t signalled;			/**< time the pending waited-for events arrived */
+    uint32_t runs;				/**< number of runs */
+    uint32_t latency_us_max;	/**< longest delay from timer expiry or signal to run */
+    uint64_t latency_us_total;	/**< sum of the delays, for the average */
+    struct sched_task *next;	/**< next registered task */
+} sched_task_t;
+
+/**
+	@brief initialize scheduler, no tasks registered
+
+	@param[in] clock : time source, NULL for sched_alarm_clock
+*/
+void sched_init(const sched_clock_t *clock);
+
+/**
+	@brief current time of the scheduler clock
+
+	@return microseconds
+*/
+uint64_t sched_now(void);
+
+/**
+	@brief register a task, without timer and waiting for no events
+
+	adding a registered task resets it
+
+	@param[in] t : task
+	@param[in] name : name for sched_dump
+	@param[in] fn : task function
+	@param[in] arg : user argument, available as t->arg
+*/
+void sched_add(sched_task_t *t, const char *name, sched_fn_t fn, void *arg);
+
+/**
+	@brief unregister a task, may be called by the task itself
+
+	@param[in] t : task
+*/
+void sched_remove(sched_task_t *t);
+
+/**
+	@brief run a task once after a delay, replaces its timer
+
+	@param[in] t : task
+	@param[in] us : delay, 0 to run as soon as possible
+*/
+void sched_after(sched_task_t *t, uint32_t us);
+
+/**
+	@brief run a task every period_us, the first time one period from now
+
+	runs are scheduled at fixed times, a late run does not delay the following ones; periods
+	missed completely are skipped
+
+	@param[in] t : task
+	@param[in] period_us : interval
+*/
+void sched_every(sched_task_t *t, uint32_t period_us);
+
+/**
+	@brief disarm the timer of a task
+
+	@param[in] t : task
+*/
+void sched_cancel(sched_task_t *t);
+
+/**
+	@brief run a task whenever one of the events is signalled
+
+	the timer keeps running: sched_wait plus sched_after is a wait with timeout
+
+	@param[in] t : task
+	@param[in] mask : events, 0 to wait for none
+*/
+void sched_wait(sched_task_t *t, uint32_t mask);
+
+/**
+	@brief signal events to a task, also from interrupt handlers
+
+	events are kept until the task waits for them
+
+	@param[in] t : task
+	@param[in] events : event bits
+*/
+void sched_signal(sched_task_t *t, uint32_t events);
+
+/**
+	@brief run every task that is due once
+
+	@return true if a task ran
+*/
+bool sched_run_once(void);
+
+/**
+	@brief run tasks and sleep in between until *stop becomes true
+
+	@param[in] stop : set e.g. by a task, NULL to run forever
+*/
+void sched_run_until(volatile bool *stop);
+
+/**
+	@brief run tasks and sleep in between for a time span
+
+	@param[in] us : time span
+*/
+void sched_run_for(uint64_t us);
+
+/**
+	@brief run tasks forever
+*/
+void sched_run(void);
+
+/**
+	@brief print runs and latency of every task
+
+	@param[in] name : prefix of the lines
+*/
+void sched_dump(const char *name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
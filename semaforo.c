@@ -2,6 +2,8 @@
 #include "pico/stdlib.h"
 #include "hardware/pwm.h"
 #include "hardware/clocks.h"
+#include "input.h"
+#include "pwm_freq.h"
 
 // Definindo os pinos dos LEDs, buzzer e botão
 #define RED_LED 2
@@ -20,11 +22,17 @@ void run();
 void light_up_red();
 void light_up_yellow();
 void light_up_green();
-uint default_traffic(uint count);
+bool hold_light(void (*light_up)(), uint duration_ms);
 void alternative_traffic();
 void pwm_init_buzzer(uint pin);
 void beep(uint pin, uint duration_ms);
 
+// Botão de pedestre, tratado por interrupção
+static input_pin_t button;
+
+// Divisor e wrap das duas frequências do beep, calculados uma vez
+static pwm_freq_t beep_low, beep_high;
+
 // Função principal que chama a inicialização e o loop principal
 int main() {
   start();
@@ -38,9 +46,9 @@ void start(){
   start_pin(GREEN_LED, GPIO_OUT);
   start_pin(PEDESTRIAN_LED, GPIO_OUT);
 
-  gpio_init(BUTTON_PIN);
-  gpio_set_dir(BUTTON_PIN, GPIO_IN);
-  gpio_pull_up(BUTTON_PIN);
+  input_init(NULL, 0);
+  input_pin_init(&button, BUTTON_PIN, true);
+  input_add(&button);
 
   gpio_init(BUZZER_PIN);
   gpio_set_dir(BUZZER_PIN, GPIO_OUT);
@@ -57,25 +65,19 @@ void start_pin(uint pin, uint config){
 
 // Função principal do programa que controla o loop
 void run(){
-  uint count = 0;
-  bool button_pressed = false;
+  const uint DEFAULT_TIME_GREEN_LED = 8000;
+  const uint DEFAULT_TIME_YELLOW_LED = 2000;
+  const uint DEFAULT_TIME_RED_LED = 10000;
 
   while(true){
-    // Verifica se o botão foi acionado
-    if(gpio_get(BUTTON_PIN) == 0){
-      button_pressed = true;
-    }
-
-    // Tráfego alternativo se o botão foi pressionado
-    if(button_pressed){
+    // Tráfego padrão; o botão interrompe o ciclo em qualquer fase
+    if(hold_light(light_up_green, DEFAULT_TIME_GREEN_LED) ||
+       hold_light(light_up_yellow, DEFAULT_TIME_YELLOW_LED) ||
+       hold_light(light_up_red, DEFAULT_TIME_RED_LED)){
+      // Tráfego alternativo se o botão foi pressionado
       alternative_traffic();
-      count = 0;
-      button_pressed = false;
-    }
-
-    // Mantém o tráfego padrão se o botão não foi acionado
-    if(!button_pressed){
-      count = default_traffic(count);
+      // Pressionamentos durante a travessia não contam
+      input_flush();
     }
   }
 }
@@ -90,29 +92,19 @@ void alternative_traffic(){
   gpio_put(PEDESTRIAN_LED, 0);
 }
 
-// Tráfego padrão dos sinais dos carros
-uint default_traffic(uint count){
-  const uint DEFAULT_TIME_GREEN_LED = 8000;
-  const uint DEFAULT_TIME_YELLOW_LED = 2000;
-  const uint DEFAULT_TIME_RED_LED = 10000;
+// Mantém um sinal aceso pelo tempo dado, dormindo até o botão ou o fim do tempo.
+// Retorna true se o botão foi pressionado.
+bool hold_light(void (*light_up)(), uint duration_ms){
+  light_up();
 
-  if(count < DEFAULT_TIME_GREEN_LED){
-    light_up_green();
-    count++;
-    sleep_ms(1);
-  } else if(count < DEFAULT_TIME_GREEN_LED + DEFAULT_TIME_YELLOW_LED){
-    light_up_yellow();
-    count++;
-    sleep_ms(1);
-  } else if(count < DEFAULT_TIME_GREEN_LED + DEFAULT_TIME_YELLOW_LED + DEFAULT_TIME_RED_LED){
-    light_up_red();
-    count++;
-    sleep_ms(1);
-  } else {
-    count = 0;
+  uint64_t until = time_us_64() + duration_ms * 1000ull;
+  input_event_t e;
+  while(input_wait(&e, until)){
+    if(e.type == INPUT_PRESS){
+      return true;
+    }
   }
-  
-  return count;
+  return false;
 }
 
 // Acende o LED vermelho e apaga os outros
@@ -143,28 +135,25 @@ void pwm_init_buzzer(uint pin) {
     pwm_config config = pwm_get_default_config();
     pwm_init(slice_num, &config, true);
     pwm_set_gpio_level(pin, 0);
+
+    // Busca o divisor e o wrap mais próximos de cada frequência (alguns ms, só aqui)
+    uint32_t clock = clock_get_hz(clk_sys);
+    beep_low = pwm_freq_solve(clock, BUZZER_FREQUENCY_LOW * 1000);
+    beep_high = pwm_freq_solve(clock, BUZZER_FREQUENCY_HIGH * 1000);
 }
 
 // Emite um beep com duração especificada e frequência intermitente
 void beep(uint pin, uint duration_ms) {
-    uint slice_num = pwm_gpio_to_slice_num(pin);
-    uint32_t freq = BUZZER_FREQUENCY_LOW;
+    bool high = false;
     uint step_duration = 100; // Duração de cada passo em ms
 
     for (uint elapsed = 0; elapsed < duration_ms; elapsed += step_duration) {
-        // Alterna a frequência entre 100 Hz e 320 Hz
-        freq = (freq == BUZZER_FREQUENCY_LOW) ? BUZZER_FREQUENCY_HIGH : BUZZER_FREQUENCY_LOW;
-
-        // Configura o divisor de clock para a nova frequência
-        pwm_set_clkdiv(slice_num, clock_get_hz(clk_sys) / (freq * 4096));
-
-        // Emite o som com a nova frequência
-        pwm_set_gpio_level(pin, 2048);
+        // Alterna a frequência entre 100 Hz e 320 Hz: só escreve divisor e wrap, 50% do duty cycle
+        high = !high;
+        pwm_freq_apply(pin, high ? beep_high : beep_low);
         sleep_ms(step_duration);
     }
 
     // Desativa o sinal PWM
     pwm_set_gpio_level(pin, 0);
 }
-
-
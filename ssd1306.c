@@ -25,6 +25,9 @@ SOFTWARE.
 
 #include <pico/stdlib.h>
 #include <hardware/i2c.h>
+#include <hardware/dma.h>
+#include <hardware/irq.h>
+#include <hardware/sync.h>
 #include <pico/binary_info.h>
 #include <stdlib.h>
 #include <string.h>
@@ -33,51 +36,228 @@ SOFTWARE.
 #include "ssd1306.h"
 #include "font.h"
 
-inline static void swap(int32_t *a, int32_t *b) {
-    int32_t *t=a;
-    *a=*b;
-    *b=*t;
+static int ssd1306_i2c_write(ssd1306_t *p, const uint8_t *src, size_t len) {
+    return i2c_write_blocking(p->i2c_i, p->address, src, len, false);
 }
 
-inline static void fancy_write(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, char *name) {
-    switch(i2c_write_blocking(i2c, addr, src, len, false)) {
+static ssd1306_t *ssd1306_dma_owner[2];
+static int ssd1306_dma_chan[2]= {-1, -1};
+static bool ssd1306_dma_abort[2];
+
+static void ssd1306_i2c_irq(uint idx) {
+    ssd1306_t *p=ssd1306_dma_owner[idx];
+    i2c_hw_t *hw=i2c_get_hw(p->i2c_i);
+    const uint32_t stat=hw->intr_stat;
+
+    if(stat&I2C_IC_INTR_STAT_R_TX_ABRT_BITS) {
+        // FIFO is flushed by the abort, stop feeding it
+        (void) hw->clr_tx_abrt;
+        dma_channel_abort(ssd1306_dma_chan[idx]);
+        ssd1306_dma_abort[idx]=true;
+    }
+
+    if(!(stat&I2C_IC_INTR_STAT_R_STOP_DET_BITS))
+        return;
+
+    (void) hw->clr_stop_det;
+    hw->intr_mask=0;
+    ssd1306_async_done(p, !ssd1306_dma_abort[idx]);
+}
+
+static void ssd1306_i2c0_irq(void) {
+    ssd1306_i2c_irq(0);
+}
+
+static void ssd1306_i2c1_irq(void) {
+    ssd1306_i2c_irq(1);
+}
+
+// the words carry RESTART/STOP bits, so the whole flush is one DMA transfer ending with a single
+// STOP; STOP_DET (or TX_ABRT) raises the i2c interrupt that completes it
+static bool ssd1306_i2c_start(ssd1306_t *p, const uint16_t *words, size_t len) {
+    const uint idx=i2c_get_index(p->i2c_i);
+    i2c_hw_t *hw=i2c_get_hw(p->i2c_i);
+
+    if(ssd1306_dma_chan[idx]<0) {
+        if((ssd1306_dma_chan[idx]=dma_claim_unused_channel(false))<0)
+            return false;
+
+        irq_set_exclusive_handler(idx?I2C1_IRQ:I2C0_IRQ, idx?ssd1306_i2c1_irq:ssd1306_i2c0_irq);
+        irq_set_enabled(idx?I2C1_IRQ:I2C0_IRQ, true);
+    }
+
+    ssd1306_dma_owner[idx]=p;
+    ssd1306_dma_abort[idx]=false;
+
+    hw->enable=0;
+    hw->tar=p->address;
+    hw->enable=1;
+
+    // TX DREQ is enabled by i2c_init
+    (void) hw->clr_stop_det;
+    (void) hw->clr_tx_abrt;
+    hw->intr_mask=I2C_IC_INTR_MASK_M_STOP_DET_BITS|I2C_IC_INTR_MASK_M_TX_ABRT_BITS;
+
+    dma_channel_config c=dma_channel_get_default_config(ssd1306_dma_chan[idx]);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, i2c_get_dreq(p->i2c_i, true));
+    dma_channel_configure(ssd1306_dma_chan[idx], &c, &hw->data_cmd, words, len, true);
+
+    return true;
+}
+
+const ssd1306_transport_t ssd1306_i2c_transport= {
+    .write=ssd1306_i2c_write,
+    .start=ssd1306_i2c_start,
+};
+
+static void ssd1306_stats_flush(ssd1306_t *p, uint64_t start) {
+    const uint64_t us=time_us_64()-start;
+    const uint32_t clamped=us>UINT32_MAX?UINT32_MAX:us;
+
+    uint32_t bucket=clamped?32-__builtin_clz(clamped):0;
+    if(bucket>=SSD1306_STATS_BUCKETS)
+        bucket=SSD1306_STATS_BUCKETS-1;
+
+    ++p->stats.flushes;
+    ++p->stats.flush_us_hist[bucket];
+    p->stats.flush_us_total+=us;
+    if(clamped>p->stats.flush_us_max)
+        p->stats.flush_us_max=clamped;
+}
+
+// src[0] is the control byte, errors are counted instead of printed: stdio may block
+inline static void fancy_write(ssd1306_t *p, const uint8_t *src, size_t len) {
+    ssd1306_flush_wait(p);
+
+    ++p->stats.transactions;
+    p->stats.bytes+=len;
+    if(src[0]&0x40)
+        p->stats.data_bytes+=len-1;
+    else
+        p->stats.command_bytes+=len-1;
+
+    switch(p->transport->write(p, src, len)) {
     case PICO_ERROR_GENERIC:
-        printf("[%s] addr not acknowledged!\n", name);
+        ++p->stats.nacks;
         break;
     case PICO_ERROR_TIMEOUT:
-        printf("[%s] timeout!\n", name);
+        ++p->stats.timeouts;
         break;
     default:
-        //printf("[%s] wrote successfully %lu bytes!\n", name, len);
         break;
     }
 }
 
-inline static void ssd1306_write(ssd1306_t *p, uint8_t val) {
-    uint8_t d[2]= {0x00, val};
-    fancy_write(p->i2c_i, p->address, d, 2, "ssd1306_write");
+void ssd1306_cmd_flush(ssd1306_t *p) {
+    if(!p->cmd_len)
+        return;
+
+    p->cmds[0]=0x00; // Co=0, D/C#=0: all following bytes are commands
+    fancy_write(p, p->cmds, p->cmd_len+1);
+    p->cmd_len=0;
+}
+
+void ssd1306_cmd_queue(ssd1306_t *p, uint8_t cmd) {
+    if(p->cmd_len==SSD1306_CMD_BATCH_MAX)
+        ssd1306_cmd_flush(p);
+
+    p->cmds[++(p->cmd_len)]=cmd;
+}
+
+void ssd1306_cmd_queue_n(ssd1306_t *p, const uint8_t *cmds, size_t len) {
+    for(size_t i=0; i<len; ++i)
+        ssd1306_cmd_queue(p, cmds[i]);
+}
+
+// data must point into a display buffer, the byte in front of it is borrowed for the control byte
+inline static void ssd1306_write_data(ssd1306_t *p, uint8_t *data, size_t len) {
+    uint8_t saved=*(data-1);
+    *(data-1)=0x40;
+    fancy_write(p, data-1, len+1);
+    *(data-1)=saved;
+}
+
+inline static void ssd1306_mark_clean(ssd1306_t *p) {
+    memset(p->dirty_x0, 0xff, sizeof(p->dirty_x0));
+    memset(p->dirty_x1, 0, sizeof(p->dirty_x1));
+}
+
+inline static void ssd1306_add_dirty_span(ssd1306_t *p, uint32_t page, uint32_t x0, uint32_t x1) {
+    if(x0<p->dirty_x0[page])
+        p->dirty_x0[page]=x0;
+    if(x1>p->dirty_x1[page])
+        p->dirty_x1[page]=x1;
+}
+
+// called by drawing functions, double buffering finds the spans on swap instead
+inline static void ssd1306_mark_dirty_span(ssd1306_t *p, uint32_t page, uint32_t x0, uint32_t x1) {
+    if(!p->front)
+        ssd1306_add_dirty_span(p, page, x0, x1);
+}
+
+// buffer read by flushes
+inline static uint8_t *ssd1306_frame(ssd1306_t *p) {
+    return p->front?p->front:p->buffer;
 }
 
 bool ssd1306_init(ssd1306_t *p, uint16_t width, uint16_t height, uint8_t address, i2c_inst_t *i2c_instance) {
+    return ssd1306_init_transport(p, &ssd1306_i2c_transport, width, height, address, i2c_instance, NULL, NULL);
+}
+
+bool ssd1306_init_static(ssd1306_t *p, uint16_t width, uint16_t height, uint8_t address, i2c_inst_t *i2c_instance, uint8_t *buffer, uint16_t *tx) {
+    return ssd1306_init_transport(p, &ssd1306_i2c_transport, width, height, address, i2c_instance, buffer, tx);
+}
+
+bool ssd1306_init_transport(ssd1306_t *p, const ssd1306_transport_t *transport, uint16_t width, uint16_t height, uint8_t address, i2c_inst_t *i2c_instance, uint8_t *buffer, uint16_t *tx) {
+    const bool static_buffer=buffer!=NULL;
+    if(height/8>SSD1306_MAX_PAGES || (!buffer && (buffer=malloc(SSD1306_BUFFER_SIZE(width, height)))==NULL)) {
+        p->bufsize=0;
+        return false;
+    }
+
     p->width=width;
     p->height=height;
     p->pages=height/8;
+    p->panel_width=width;
+    p->panel_pages=p->pages;
+    p->rotation=SSD1306_ROTATE_0;
+    p->mirror=false;
+    p->rotated=NULL;
     p->address=address;
 
     p->i2c_i=i2c_instance;
+    p->cmd_len=0;
 
+    p->transport=transport?transport:&ssd1306_i2c_transport;
+    p->tx=tx;
+    p->static_tx=tx!=NULL;
+    p->tx_len=0;
+    p->busy=false;
+    ssd1306_stats_reset(p);
+    p->scrolling=false;
+    p->start_line=0;
+    p->start_line_pending=false;
+    p->frame_depth=0;
+    p->frame_async=false;
 
+
+    // the byte before the buffer is borrowed for the control byte
     p->bufsize=(p->pages)*(p->width);
-    if((p->buffer=malloc(p->bufsize+1))==NULL) {
-        p->bufsize=0;
-        return false;
-    }
+    p->buffer=buffer+1;
+    p->static_buffer=static_buffer;
+    p->front=NULL;
+    ssd1306_reset_clip(p);
 
-    ++(p->buffer);
+    // panel RAM content is unknown after reset, first show sends everything
+    ssd1306_invalidate(p);
 
     // from https://github.com/makerportal/rpi-pico-ssd1306
     uint8_t cmds[]= {
         SET_DISP,
+        SET_SCROLL_OFF,                 // may still run if only the MCU was reset
         // timing and driving scheme
         SET_DISP_CLK_DIV,
         0x80,
@@ -109,81 +289,488 @@ bool ssd1306_init(ssd1306_t *p, uint16_t width, uint16_t height, uint8_t address
         0x00,  // horizontal
     };
 
-    for(size_t i=0; i<sizeof(cmds); ++i)
-        ssd1306_write(p, cmds[i]);
+    ssd1306_cmd_queue_n(p, cmds, sizeof(cmds));
+    ssd1306_cmd_flush(p);
 
     return true;
 }
 
 inline void ssd1306_deinit(ssd1306_t *p) {
-    free(p->buffer-1);
+    ssd1306_flush_wait(p);
+    if(!p->static_tx)
+        free(p->tx);
+    if(p->rotated)
+        free(p->rotated-1);
+    if(p->front)
+        free(p->front-1);
+    if(!p->static_buffer)
+        free(p->buffer-1);
 }
 
 inline void ssd1306_poweroff(ssd1306_t *p) {
-    ssd1306_write(p, SET_DISP|0x00);
+    ssd1306_cmd_queue(p, SET_DISP|0x00);
+    ssd1306_cmd_flush(p);
 }
 
 inline void ssd1306_poweron(ssd1306_t *p) {
-    ssd1306_write(p, SET_DISP|0x01);
+    ssd1306_cmd_queue(p, SET_DISP|0x01);
+    ssd1306_cmd_flush(p);
 }
 
 inline void ssd1306_contrast(ssd1306_t *p, uint8_t val) {
-    ssd1306_write(p, SET_CONTRAST);
-    ssd1306_write(p, val);
+    ssd1306_cmd_queue(p, SET_CONTRAST);
+    ssd1306_cmd_queue(p, val);
+    ssd1306_cmd_flush(p);
 }
 
 inline void ssd1306_invert(ssd1306_t *p, uint8_t inv) {
-    ssd1306_write(p, SET_NORM_INV | (inv & 1));
+    ssd1306_cmd_queue(p, SET_NORM_INV | (inv & 1));
+    ssd1306_cmd_flush(p);
+}
+
+bool ssd1306_set_rotation(ssd1306_t *p, ssd1306_rotation_t rotation, bool mirror) {
+    const bool transposed=rotation==SSD1306_ROTATE_90 || rotation==SSD1306_ROTATE_270;
+
+    ssd1306_flush_wait(p);
+    if(p->scrolling)
+        ssd1306_scroll_stop(p);
+
+    if(transposed && !p->rotated) {
+        uint8_t *rotated=malloc(p->bufsize+1);
+        if(!rotated)
+            return false;
+        p->rotated=rotated+1;
+    } else if(!transposed && p->rotated) {
+        free(p->rotated-1);
+        p->rotated=NULL;
+    }
+
+    // 90 and 270 send the transposed buffer, flipping columns and rows is left to the panel
+    bool flip_x, flip_y;
+    switch(rotation) {
+    case SSD1306_ROTATE_90:
+        flip_x=true;
+        flip_y=mirror;
+        break;
+    case SSD1306_ROTATE_180:
+        flip_x=!mirror;
+        flip_y=true;
+        break;
+    case SSD1306_ROTATE_270:
+        flip_x=false;
+        flip_y=!mirror;
+        break;
+    default:
+        flip_x=mirror;
+        flip_y=false;
+        break;
+    }
+
+    p->rotation=rotation;
+    p->mirror=mirror;
+    p->width=transposed?p->panel_pages<<3:p->panel_width;
+    p->height=transposed?p->panel_width:p->panel_pages<<3;
+    p->pages=p->height>>3;
+
+    memset(p->buffer, 0, p->bufsize);
+    if(p->front)
+        memset(p->front, 0, p->bufsize);
+    ssd1306_reset_clip(p);
+
+    // SEG remap only applies to data written after it, the whole RAM is rewritten
+    ssd1306_invalidate(p);
+
+    const uint8_t cmds[]= {
+        SET_SEG_REMAP|(flip_x?0x00:0x01),
+        SET_COM_OUT_DIR|(flip_y?0x00:0x08),
+    };
+    ssd1306_cmd_queue_n(p, cmds, sizeof(cmds));
+    ssd1306_cmd_flush(p);
+
+    return true;
+}
+
+// the panel flips columns for 180 degrees and mirroring, horizontal scrolling turns around
+inline static bool ssd1306_columns_flipped(ssd1306_t *p) {
+    return (p->rotation==SSD1306_ROTATE_180)!=p->mirror;
+}
+
+// scroll step interval in frames, index is the value sent to the panel
+static const uint16_t ssd1306_scroll_frames[8]= {5, 64, 128, 256, 3, 4, 25, 2};
+
+static uint8_t ssd1306_scroll_interval(uint32_t frames) {
+    uint8_t best=0;
+    for(uint8_t i=1; i<8; ++i)
+        if(abs((int32_t) ssd1306_scroll_frames[i]-(int32_t) frames)<abs((int32_t) ssd1306_scroll_frames[best]-(int32_t) frames))
+            best=i;
+    return best;
+}
+
+// pending changes go out before the panel takes over the pages
+static void ssd1306_scroll_begin(ssd1306_t *p, uint32_t page0, uint32_t page1) {
+    if(p->scrolling)
+        ssd1306_scroll_stop(p);
+    ssd1306_show(p);
+
+    p->scroll_page0=page0;
+    p->scroll_page1=page1;
+    p->scrolling=true;
+}
+
+void ssd1306_scroll_horizontal(ssd1306_t *p, uint32_t page0, uint32_t page1, bool left, uint32_t frames) {
+    if(page1>=p->pages)
+        page1=p->pages-1;
+    if(page0>page1 || p->rotated)
+        return;
+
+    left^=ssd1306_columns_flipped(p);
+
+    ssd1306_scroll_begin(p, page0, page1);
+
+    const uint8_t cmds[]= {
+        left?SET_HSCROLL_LEFT:SET_HSCROLL_RIGHT,
+        0x00,
+        page0,
+        ssd1306_scroll_interval(frames),
+        page1,
+        0x00,
+        0xff,
+        SET_SCROLL_ON,
+    };
+    ssd1306_cmd_queue_n(p, cmds, sizeof(cmds));
+    ssd1306_cmd_flush(p);
+}
+
+void ssd1306_scroll_diagonal(ssd1306_t *p, uint32_t page0, uint32_t page1, bool left, uint32_t frames, uint32_t vertical_offset, uint32_t area_top, uint32_t area_rows) {
+    if(page1>=p->pages)
+        page1=p->pages-1;
+    if(page0>page1 || area_top+area_rows>p->height || p->rotated)
+        return;
+
+    left^=ssd1306_columns_flipped(p);
+
+    // the vertical part moves rows of every page
+    ssd1306_scroll_begin(p, 0, p->pages-1);
+
+    const uint8_t cmds[]= {
+        SET_VSCROLL_AREA,
+        area_top,
+        area_rows,
+        left?SET_VHSCROLL_LEFT:SET_VHSCROLL_RIGHT,
+        0x00,
+        page0,
+        ssd1306_scroll_interval(frames),
+        page1,
+        vertical_offset&0x3f,
+        SET_SCROLL_ON,
+    };
+    ssd1306_cmd_queue_n(p, cmds, sizeof(cmds));
+    ssd1306_cmd_flush(p);
 }
 
-inline void ssd1306_clear(ssd1306_t *p) {
+void ssd1306_scroll_stop(ssd1306_t *p) {
+    ssd1306_cmd_queue(p, SET_SCROLL_OFF);
+    ssd1306_cmd_flush(p);
+
+    if(!p->scrolling)
+        return;
+
+    // the panel RAM of the scrolled pages is wherever the scroll left it
+    p->scrolling=false;
+    for(uint32_t page=p->scroll_page0; page<=p->scroll_page1; ++page)
+        ssd1306_add_dirty_span(p, page, 0, p->width-1);
+}
+
+uint32_t ssd1306_scroll_vertical(ssd1306_t *p, int32_t lines) {
+    if(p->height!=64 || p->rotated)
+        return 0;
+
+    p->start_line=(p->start_line+lines)&0x3f;
+    p->start_line_pending=true;
+
+    return lines>0?(p->start_line+p->height-lines)&0x3f:p->start_line;
+}
+
+uint32_t ssd1306_ram_row(ssd1306_t *p, uint32_t y) {
+    return p->height==64 && !p->rotated?(y+p->start_line)&0x3f:y;
+}
+
+void ssd1306_clear(ssd1306_t *p) {
+    // only columns holding set pixels change on the panel
+    for(uint32_t page=0; page<p->pages && !p->front; ++page) {
+        const uint8_t *row=p->buffer+page*p->width;
+        int32_t x0=0, x1=p->width-1;
+
+        while(x0<=x1 && !row[x0])
+            ++x0;
+        while(x1>x0 && !row[x1])
+            --x1;
+
+        if(x0<=x1)
+            ssd1306_mark_dirty_span(p, page, x0, x1);
+    }
+
     memset(p->buffer, 0, p->bufsize);
 }
 
 void ssd1306_clear_pixel(ssd1306_t *p, uint32_t x, uint32_t y) {
-    if(x>=p->width || y>=p->height) return;
+    if(x<p->clip_x0 || x>=p->clip_x1 || y<p->clip_y0 || y>=p->clip_y1) return;
 
-    p->buffer[x+p->width*(y>>3)]&=~(0x1<<(y&0x07));
+    uint8_t *b=&p->buffer[x+p->width*(y>>3)];
+    const uint8_t v=*b&~(0x1<<(y&0x07));
+    if(v!=*b) {
+        *b=v;
+        ssd1306_mark_dirty_span(p, y>>3, x, x);
+    }
 }
 
 void ssd1306_draw_pixel(ssd1306_t *p, uint32_t x, uint32_t y) {
-    if(x>=p->width || y>=p->height) return;
+    if(x<p->clip_x0 || x>=p->clip_x1 || y<p->clip_y0 || y>=p->clip_y1) return;
+
+    uint8_t *b=&p->buffer[x+p->width*(y>>3)];
+    const uint8_t v=*b|(0x1<<(y&0x07)); // y>>3==y/8 && y&0x7==y%8
+    if(v!=*b) {
+        *b=v;
+        ssd1306_mark_dirty_span(p, y>>3, x, x);
+    }
+}
+
+void ssd1306_mark_dirty(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
+    if(x>=p->width || y>=p->height || !width || !height) return;
+
+    uint32_t x1=x+width-1, y1=y+height-1;
+    if(x1>=p->width)
+        x1=p->width-1;
+    if(y1>=p->height)
+        y1=p->height-1;
 
-    p->buffer[x+p->width*(y>>3)]|=0x1<<(y&0x07); // y>>3==y/8 && y&0x7==y%8
+    for(uint32_t page=y>>3; page<=(y1>>3); ++page)
+        ssd1306_mark_dirty_span(p, page, x, x1);
+}
+
+bool ssd1306_double_buffer(ssd1306_t *p, bool diff_on_swap) {
+    if(!p->front) {
+        if((p->front=malloc(p->bufsize+1))==NULL)
+            return false;
+
+        ++(p->front);
+        memcpy(p->front, p->buffer, p->bufsize);
+    }
+
+    p->diff_on_swap=diff_on_swap;
+    return true;
+}
+
+void ssd1306_swap(ssd1306_t *p) {
+    if(!p->front)
+        return;
+
+    // background flushes work on a copy, the buffers may be exchanged at any time
+    uint8_t *shown=p->front;
+    p->front=p->buffer;
+    p->buffer=shown;
+
+    if(!p->diff_on_swap) {
+        ssd1306_invalidate(p);
+        return;
+    }
+
+    for(uint32_t page=0; page<p->pages; ++page) {
+        const uint8_t *a=p->front+page*p->width, *b=shown+page*p->width;
+        if(!memcmp(a, b, p->width))
+            continue;
+
+        uint32_t x0=0, x1=p->width-1;
+        while(a[x0]==b[x0])
+            ++x0;
+        while(a[x1]==b[x1])
+            --x1;
+
+        ssd1306_add_dirty_span(p, page, x0, x1);
+    }
+}
+
+inline void ssd1306_invalidate(ssd1306_t *p) {
+    memset(p->dirty_x0, 0, sizeof(p->dirty_x0));
+    memset(p->dirty_x1, p->width-1, sizeof(p->dirty_x1));
+}
+
+// clips rectangle to clip area, false if nothing is left
+inline static bool ssd1306_clip(ssd1306_t *p, int32_t *x, int32_t *y, int32_t *width, int32_t *height) {
+    if(*x<p->clip_x0) {
+        *width-=p->clip_x0-*x;
+        *x=p->clip_x0;
+    }
+    if(*y<p->clip_y0) {
+        *height-=p->clip_y0-*y;
+        *y=p->clip_y0;
+    }
+    if(*x+*width>p->clip_x1)
+        *width=p->clip_x1-*x;
+    if(*y+*height>p->clip_y1)
+        *height=p->clip_y1-*y;
+
+    return *width>0 && *height>0;
+}
+
+// rows of page inside the clip area
+inline static uint8_t ssd1306_clip_mask(ssd1306_t *p, int32_t page) {
+    if(p->clip_y0>=p->clip_y1 || page<(p->clip_y0>>3) || page>((p->clip_y1-1)>>3))
+        return 0;
+
+    uint8_t mask=0xff;
+    if(page==(p->clip_y0>>3))
+        mask&=0xff<<(p->clip_y0&0x07);
+    if(page==((p->clip_y1-1)>>3))
+        mask&=0xff>>(7-((p->clip_y1-1)&0x07));
+    return mask;
+}
+
+void ssd1306_set_clip(ssd1306_t *p, int32_t x, int32_t y, uint32_t width, uint32_t height) {
+    int32_t w=width, h=height;
+
+    ssd1306_reset_clip(p);
+    if(!ssd1306_clip(p, &x, &y, &w, &h)) {
+        p->clip_x1=p->clip_x0;
+        p->clip_y1=p->clip_y0;
+        return;
+    }
+
+    p->clip_x0=x;
+    p->clip_y0=y;
+    p->clip_x1=x+w;
+    p->clip_y1=y+h;
+}
+
+void ssd1306_reset_clip(ssd1306_t *p) {
+    p->clip_x0=0;
+    p->clip_y0=0;
+    p->clip_x1=p->width;
+    p->clip_y1=p->height;
+}
+
+enum {
+    SSD1306_SPAN_SET,
+    SSD1306_SPAN_CLEAR,
+    SSD1306_SPAN_XOR,
+};
+
+inline static uint32_t ssd1306_span_op(uint32_t v, uint32_t m, int op) {
+    switch(op) {
+    case SSD1306_SPAN_SET:
+        return v|m;
+    case SSD1306_SPAN_CLEAR:
+        return v&~m;
+    default:
+        return v^m;
+    }
+}
+
+// applies mask m to n consecutive column bytes of one page, a word at a time where aligned
+static void ssd1306_span_apply(uint8_t *b, uint32_t n, uint8_t m, int op) {
+    if(m==0xff && op!=SSD1306_SPAN_XOR) {
+        memset(b, op==SSD1306_SPAN_SET?0xff:0x00, n);
+        return;
+    }
+
+    for(; n && ((uintptr_t) b&3); --n, ++b)
+        *b=ssd1306_span_op(*b, m, op);
+
+    // words through memcpy, no aliasing of the byte buffer; aligned now, so single word accesses
+    const uint32_t m32=m*0x01010101u;
+    uint8_t *a=__builtin_assume_aligned(b, 4);
+    for(; n>=4; n-=4, a+=4) {
+        uint32_t w;
+        memcpy(&w, a, 4);
+        w=ssd1306_span_op(w, m32, op);
+        memcpy(a, &w, 4);
+    }
+
+    for(b=a; n; --n, ++b)
+        *b=ssd1306_span_op(*b, m, op);
+}
+
+// rectangle as one column run per page, top/bottom page masked, pattern repeats every 8 rows
+static void ssd1306_span_fill(ssd1306_t *p, int32_t x, int32_t y, int32_t width, int32_t height, int op, uint8_t pattern) {
+    if(!ssd1306_clip(p, &x, &y, &width, &height))
+        return;
+
+    const int32_t y1=y+height-1;
+    for(int32_t page=y>>3; page<=(y1>>3); ++page) {
+        uint8_t mask=pattern;
+        if(page==(y>>3))
+            mask&=0xff<<(y&0x07);
+        if(page==(y1>>3))
+            mask&=0xff>>(7-(y1&0x07));
+
+        ssd1306_span_apply(p->buffer+p->width*page+x, width, mask, op);
+        ssd1306_mark_dirty_span(p, page, x, x+width-1);
+    }
+}
+
+void ssd1306_fill_rect(ssd1306_t *p, int32_t x, int32_t y, uint32_t width, uint32_t height) {
+    ssd1306_span_fill(p, x, y, width, height, SSD1306_SPAN_SET, 0xff);
+}
+
+void ssd1306_clear_rect(ssd1306_t *p, int32_t x, int32_t y, uint32_t width, uint32_t height) {
+    ssd1306_span_fill(p, x, y, width, height, SSD1306_SPAN_CLEAR, 0xff);
+}
+
+void ssd1306_invert_rect(ssd1306_t *p, int32_t x, int32_t y, uint32_t width, uint32_t height) {
+    ssd1306_span_fill(p, x, y, width, height, SSD1306_SPAN_XOR, 0xff);
+}
+
+void ssd1306_xor_rect(ssd1306_t *p, int32_t x, int32_t y, uint32_t width, uint32_t height, uint8_t pattern) {
+    ssd1306_span_fill(p, x, y, width, height, SSD1306_SPAN_XOR, pattern);
+}
+
+void ssd1306_draw_hline(ssd1306_t *p, int32_t x, int32_t y, int32_t width) {
+    ssd1306_span_fill(p, x, y, width, 1, SSD1306_SPAN_SET, 0xff);
+}
+
+void ssd1306_draw_vline(ssd1306_t *p, int32_t x, int32_t y, int32_t height) {
+    ssd1306_span_fill(p, x, y, 1, height, SSD1306_SPAN_SET, 0xff);
 }
 
 void ssd1306_draw_line(ssd1306_t *p, int32_t x1, int32_t y1, int32_t x2, int32_t y2) {
-    if(x1>x2) {
-        swap(&x1, &x2);
-        swap(&y1, &y2);
+    if(y1==y2) {
+        ssd1306_draw_hline(p, x1<x2?x1:x2, y1, abs(x2-x1)+1);
+        return;
     }
 
     if(x1==x2) {
-        if(y1>y2)
-            swap(&y1, &y2);
-        for(int32_t i=y1; i<=y2; ++i)
-            ssd1306_draw_pixel(p, x1, i);
+        ssd1306_draw_vline(p, x1, y1<y2?y1:y2, abs(y2-y1)+1);
         return;
     }
 
-    float m=(float) (y2-y1) / (float) (x2-x1);
+    // Bresenham, all octants
+    const int32_t dx=abs(x2-x1), sx=x1<x2?1:-1;
+    const int32_t dy=-abs(y2-y1), sy=y1<y2?1:-1;
+    int32_t err=dx+dy;
+
+    for(;;) {
+        ssd1306_draw_pixel(p, x1, y1);
+        if(x1==x2 && y1==y2)
+            break;
 
-    for(int32_t i=x1; i<=x2; ++i) {
-        float y=m*(float) (i-x1)+(float) y1;
-        ssd1306_draw_pixel(p, i, (uint32_t) y);
+        const int32_t e2=2*err;
+        if(e2>=dy) {
+            err+=dy;
+            x1+=sx;
+        }
+        if(e2<=dx) {
+            err+=dx;
+            y1+=sy;
+        }
     }
 }
 
 void ssd1306_clear_square(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
-    for(uint32_t i=0; i<width; ++i)
-        for(uint32_t j=0; j<height; ++j)
-            ssd1306_clear_pixel(p, x+i, y+j);
+    ssd1306_clear_rect(p, x, y, width, height);
 }
 
 void ssd1306_draw_square(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
-    for(uint32_t i=0; i<width; ++i)
-        for(uint32_t j=0; j<height; ++j)
-            ssd1306_draw_pixel(p, x+i, y+j);
+    ssd1306_fill_rect(p, x, y, width, height);
 }
 
 void ssd1306_draw_empty_square(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
@@ -193,30 +780,395 @@ void ssd1306_draw_empty_square(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t wi
     ssd1306_draw_line(p, x+width, y, x+width, y+height);
 }
 
-void ssd1306_draw_char_with_font(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t scale, const uint8_t *font, char c) {
-    if(c<font[3]||c>font[4])
+// ORs a bitmap into the buffer; column i, page k of the bitmap is src[i*col_stride+k*page_stride]
+// (col_stride 0 repeats one column). page aligned y costs one store per column and page,
+// otherwise every source byte is split over two pages
+static void ssd1306_blit_or(ssd1306_t *p, int32_t x, int32_t y, const uint8_t *src, int32_t width, int32_t height, size_t col_stride, size_t page_stride) {
+    int32_t c0=x<p->clip_x0?p->clip_x0-x:0, c1=width;
+    if(x+c1>p->clip_x1)
+        c1=p->clip_x1-x;
+    if(c0>=c1 || height<=0 || y>=p->clip_y1 || y+height<=p->clip_y0)
+        return;
+
+    const int32_t src_pages=(height+7)>>3;
+    const uint8_t last_mask=0xff>>((src_pages<<3)-height);
+    const int32_t page0=y>>3; // rounds down for negative y
+    const uint32_t shift=y&0x07;
+    const int32_t dst_pages=src_pages+(shift?1:0);
+
+    // only pages overlapping the clip area are written, starting one early for the carry
+    uint8_t masks[SSD1306_MAX_PAGES];
+    for(int32_t page=0; page<p->pages; ++page)
+        masks[page]=ssd1306_clip_mask(p, page);
+
+    const int32_t k0=page0<0?-page0-1:0;
+    const int32_t k1=page0+dst_pages>p->pages?p->pages-page0:dst_pages;
+
+    for(int32_t i=c0; i<c1; ++i) {
+        const uint8_t *s=src+i*col_stride;
+        uint8_t *d=p->buffer+x+i;
+        uint32_t v=0;
+
+        for(int32_t k=k0; k<k1; ++k) {
+            v>>=8;
+            if(k<src_pages)
+                v|=(uint32_t) (s[k*page_stride]&(k==src_pages-1?last_mask:0xff))<<shift;
+
+            if(page0+k>=0)
+                d[p->width*(page0+k)]|=v&masks[page0+k];
+        }
+    }
+
+    for(int32_t k=k0; k<k1; ++k)
+        if(page0+k>=0 && masks[page0+k])
+            ssd1306_mark_dirty_span(p, page0+k, x+c0, x+c1-1);
+}
+
+#ifndef SSD1306_GLYPH_CACHE_ENTRIES
+#define SSD1306_GLYPH_CACHE_ENTRIES 8
+#endif
+
+#ifndef SSD1306_GLYPH_CACHE_BYTES
+#define SSD1306_GLYPH_CACHE_BYTES 160
+#endif
+
+// largest glyph of a compressed font (width * bytes per column) that can be drawn
+#ifndef SSD1306_RLE_GLYPH_MAX
+#define SSD1306_RLE_GLYPH_MAX 256
+#endif
+
+#define SSD1306_FONT_RLE 0x01
+
+// scaled glyphs, column major like the fonts
+static struct {
+    const uint8_t *font;
+    char c;
+    uint8_t scale;
+    uint32_t used;
+    uint8_t data[SSD1306_GLYPH_CACHE_BYTES];
+} ssd1306_glyph_cache[SSD1306_GLYPH_CACHE_ENTRIES];
+
+static uint32_t ssd1306_glyph_clock;
+
+// every bit of a nibble doubled
+static const uint8_t ssd1306_spread2[16]= {
+    0x00, 0x03, 0x0c, 0x0f, 0x30, 0x33, 0x3c, 0x3f,
+    0xc0, 0xc3, 0xcc, 0xcf, 0xf0, 0xf3, 0xfc, 0xff
+};
+
+// repeats every bit of a glyph column scale times, result must fit 64 rows
+static uint64_t ssd1306_spread(uint32_t bits, uint32_t scale) {
+    uint64_t r=0;
+
+    if(scale==2) {
+        for(uint32_t i=0; bits; ++i, bits>>=4)
+            r|=(uint64_t) ssd1306_spread2[bits&0x0f]<<(i<<3);
+        return r;
+    }
+
+    const uint64_t run=scale>=64?~0ull:(1ull<<scale)-1;
+    for(uint32_t i=0; bits; ++i, bits>>=1)
+        if(bits&1)
+            r|=run<<(i*scale);
+    return r;
+}
+
+inline static uint32_t ssd1306_glyph_column(const uint8_t *glyph, uint32_t parts_per_line, uint32_t height) {
+    uint32_t bits=0;
+    for(uint32_t lp=0; lp<parts_per_line; ++lp)
+        bits|=(uint32_t) glyph[lp]<<(lp<<3);
+
+    return height<32?bits&((1u<<height)-1):bits;
+}
+
+// header of either font format, see font.h
+typedef struct {
+    uint8_t flags;
+    uint8_t height;
+    uint8_t width;				// fixed width fonts only
+    uint8_t spacing;
+    uint8_t first;
+    uint8_t last;
+    uint8_t parts_per_line;
+    uint8_t kerning_pairs;
+    const uint8_t *index;		// proportional fonts: offset low, offset high, width per glyph
+    const uint8_t *kerning;
+    const uint8_t *data;
+} ssd1306_font_info_t;
+
+static void ssd1306_font_info(const uint8_t *font, ssd1306_font_info_t *f) {
+    if(font[0]) {
+        f->flags=0;
+        f->height=font[0];
+        f->width=font[1];
+        f->spacing=font[2];
+        f->first=font[3];
+        f->last=font[4];
+        f->kerning_pairs=0;
+        f->index=NULL;
+        f->kerning=NULL;
+        f->data=font+5;
+    } else {
+        f->flags=font[1];
+        f->height=font[2];
+        f->width=0;
+        f->spacing=font[3];
+        f->first=font[4];
+        f->last=font[5];
+        f->kerning_pairs=font[6];
+        f->index=font+7;
+        f->kerning=f->index+3*(f->last-f->first+1);
+        f->data=f->kerning+3*f->kerning_pairs;
+    }
+    f->parts_per_line=(f->height>>3)+((f->height&7)>0);
+}
+
+static bool ssd1306_font_glyph(const ssd1306_font_info_t *f, char c, const uint8_t **glyph, uint32_t *width) {
+    const uint8_t ch=c;
+    if(ch<f->first || ch>f->last)
+        return false;
+
+    if(!f->index) {
+        *width=f->width;
+        *glyph=f->data+(ch-f->first)*f->width*f->parts_per_line;
+        return true;
+    }
+
+    const uint8_t *entry=f->index+3*(ch-f->first);
+    *width=entry[2];
+    *glyph=f->data+(entry[0]|(entry[1]<<8));
+    return true;
+}
+
+inline static int32_t ssd1306_font_kerning(const ssd1306_font_info_t *f, char left, char right) {
+    for(uint32_t i=0; i<f->kerning_pairs; ++i)
+        if(f->kerning[3*i]==(uint8_t) left && f->kerning[3*i+1]==(uint8_t) right)
+            return (int8_t) f->kerning[3*i+2];
+    return 0;
+}
+
+/*
+ * compressed glyphs are stored page by page, each page row holding the
+ * bytes of every column, as a sequence of runs:
+ * 0x00-0x7f: n+1 literal bytes follow
+ * 0x80-0xff: the next byte repeats n-0x80+2 times
+ * decoded into the column major layout of uncompressed glyphs
+ */
+static bool ssd1306_rle_decode(const uint8_t *src, uint8_t *dst, uint32_t width, uint32_t parts_per_line) {
+    // nothing to decode, and col would never wrap to the next page
+    if(!width)
+        return false;
+
+    uint32_t col=0, page=0;
+    while(page<parts_per_line) {
+        const uint8_t run=*src++;
+        const bool repeat=run&0x80;
+        uint32_t n=repeat?run-0x80+2:run+1;
+
+        for(; n; --n) {
+            if(page>=parts_per_line)
+                return false;
+            dst[col*parts_per_line+page]=repeat?*src:*src++;
+            if(++col==width) {
+                col=0;
+                ++page;
+            }
+        }
+        if(repeat)
+            ++src;
+    }
+    return true;
+}
+
+// horizontal distance from c to the next character
+static int32_t ssd1306_font_advance(const ssd1306_font_info_t *f, char c, char next) {
+    const uint8_t *glyph;
+    uint32_t width;
+    if(!ssd1306_font_glyph(f, c, &glyph, &width))
+        width=f->index?0:f->width;
+
+    return width+f->spacing+(next?ssd1306_font_kerning(f, c, next):0);
+}
+
+// returns the glyph expanded to scale, NULL if it does not fit a cache entry
+static const uint8_t *ssd1306_glyph_scaled(const uint8_t *font, const ssd1306_font_info_t *f, char c, const uint8_t *glyph, uint32_t width, uint32_t scale) {
+    const uint32_t pages=(f->height*scale+7)>>3;
+    if(width*scale*pages>SSD1306_GLYPH_CACHE_BYTES)
+        return NULL;
+
+    uint32_t lru=0;
+    for(uint32_t i=0; i<SSD1306_GLYPH_CACHE_ENTRIES; ++i) {
+        if(ssd1306_glyph_cache[i].font==font && ssd1306_glyph_cache[i].c==c && ssd1306_glyph_cache[i].scale==scale) {
+            ssd1306_glyph_cache[i].used=++ssd1306_glyph_clock;
+            return ssd1306_glyph_cache[i].data;
+        }
+        if(ssd1306_glyph_cache[i].used<ssd1306_glyph_cache[lru].used)
+            lru=i;
+    }
+
+    uint8_t *d=ssd1306_glyph_cache[lru].data;
+    for(uint32_t w=0; w<width; ++w, glyph+=f->parts_per_line) {
+        const uint64_t col=ssd1306_spread(ssd1306_glyph_column(glyph, f->parts_per_line, f->height), scale);
+
+        for(uint32_t i=0; i<scale; ++i)
+            for(uint32_t k=0; k<pages; ++k)
+                *d++=col>>(k<<3);
+    }
+
+    ssd1306_glyph_cache[lru].font=font;
+    ssd1306_glyph_cache[lru].c=c;
+    ssd1306_glyph_cache[lru].scale=scale;
+    ssd1306_glyph_cache[lru].used=++ssd1306_glyph_clock;
+    return ssd1306_glyph_cache[lru].data;
+}
+
+static void ssd1306_draw_glyph(ssd1306_t *p, int32_t x, int32_t y, uint32_t scale, const uint8_t *font, const ssd1306_font_info_t *f, char c) {
+    const uint8_t *glyph;
+    uint32_t width;
+    // characters dropped by subsetting have width 0
+    if(!scale || !ssd1306_font_glyph(f, c, &glyph, &width) || !width)
         return;
 
-    uint32_t parts_per_line=(font[0]>>3)+((font[0]&7)>0);
-    for(uint8_t w=0; w<font[1]; ++w) { // width
-        uint32_t pp=(c-font[3])*font[1]*parts_per_line+w*parts_per_line+5;
-        for(uint32_t lp=0; lp<parts_per_line; ++lp) {
-            uint8_t line=font[pp];
+    uint8_t unpacked[SSD1306_RLE_GLYPH_MAX];
+    if(f->flags&SSD1306_FONT_RLE) {
+        if(width*f->parts_per_line>SSD1306_RLE_GLYPH_MAX || !ssd1306_rle_decode(glyph, unpacked, width, f->parts_per_line))
+            return;
+        glyph=unpacked;
+    }
+
+    if(scale==1) {
+        ssd1306_blit_or(p, x, y, glyph, width, f->height, f->parts_per_line, 1);
+        return;
+    }
+
+    if(f->height*scale<=64) {
+        const uint32_t pages=(f->height*scale+7)>>3;
+        const uint8_t *scaled=ssd1306_glyph_scaled(font, f, c, glyph, width, scale);
+
+        if(scaled) {
+            ssd1306_blit_or(p, x, y, scaled, width*scale, f->height*scale, pages, 1);
+            return;
+        }
+
+        // too big for the cache: expand one column at a time and repeat it scale times
+        for(uint32_t w=0; w<width; ++w, glyph+=f->parts_per_line) {
+            const uint64_t col=ssd1306_spread(ssd1306_glyph_column(glyph, f->parts_per_line, f->height), scale);
+            uint8_t bytes[8];
+            for(uint32_t k=0; k<pages; ++k)
+                bytes[k]=col>>(k<<3);
+
+            ssd1306_blit_or(p, x+w*scale, y, bytes, scale, f->height*scale, 0, 1);
+        }
+        return;
+    }
+
+    for(uint32_t w=0; w<width; ++w) { // width
+        for(uint32_t lp=0; lp<f->parts_per_line; ++lp) {
+            uint8_t line=*(glyph++);
 
             for(int8_t j=0; j<8; ++j, line>>=1) {
                 if(line & 1)
-                    ssd1306_draw_square(p, x+w*scale, y+((lp<<3)+j)*scale, scale, scale);
+                    ssd1306_fill_rect(p, x+w*scale, y+((lp<<3)+j)*scale, scale, scale);
             }
-
-            ++pp;
         }
     }
 }
 
+void ssd1306_draw_char_with_font(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t scale, const uint8_t *font, char c) {
+    ssd1306_font_info_t f;
+    ssd1306_font_info(font, &f);
+
+    ssd1306_draw_glyph(p, x, y, scale, font, &f, c);
+}
+
+// draws n characters, returns x after the last one
+static int32_t ssd1306_draw_chars(ssd1306_t *p, int32_t x, int32_t y, uint32_t scale, const uint8_t *font, const ssd1306_font_info_t *f, const char *s, size_t n) {
+    for(size_t i=0; i<n; ++i) {
+        ssd1306_draw_glyph(p, x, y, scale, font, f, s[i]);
+        x+=ssd1306_font_advance(f, s[i], i+1<n?s[i+1]:0)*scale;
+    }
+    return x;
+}
+
 void ssd1306_draw_string_with_font(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t scale, const uint8_t *font, const char *s) {
-    for(int32_t x_n=x; *s; x_n+=(font[1]+font[2])*scale) {
-        ssd1306_draw_char_with_font(p, x_n, y, scale, font, *(s++));
+    ssd1306_font_info_t f;
+    ssd1306_font_info(font, &f);
+
+    ssd1306_draw_chars(p, x, y, scale, font, &f, s, strlen(s));
+}
+
+uint32_t ssd1306_font_height(const uint8_t *font, uint32_t scale) {
+    return (font[0]?font[0]:font[2])*scale;
+}
+
+uint32_t ssd1306_measure_string(const uint8_t *font, uint32_t scale, const char *s) {
+    ssd1306_font_info_t f;
+    ssd1306_font_info(font, &f);
+
+    int32_t width=0;
+    for(; *s; ++s)
+        width+=ssd1306_font_advance(&f, *s, s[1]);
+
+    // no spacing after the last character
+    if(width>f.spacing)
+        width-=f.spacing;
+    return width*scale;
+}
+
+const char *ssd1306_draw_string_wrapped(ssd1306_t *p, int32_t x, int32_t y, uint32_t width, uint32_t height, uint32_t scale, const uint8_t *font, const char *s) {
+    ssd1306_font_info_t f;
+    ssd1306_font_info(font, &f);
+
+    const int32_t line_height=f.height*scale;
+    const uint8_t clip[4]= {p->clip_x0, p->clip_y0, p->clip_x1, p->clip_y1};
+
+    // text never leaves the rectangle (nor the clip area set by the caller)
+    int32_t cx=x, cy=y, cw=width, ch=height;
+    if(!ssd1306_clip(p, &cx, &cy, &cw, &ch))
+        cw=ch=0;
+    ssd1306_set_clip(p, cx, cy, cw, ch);
+
+    for(int32_t line_y=y; *s && line_y+line_height<=y+(int32_t) height; line_y+=line_height) {
+        while(*s==' ')
+            ++s;
+
+        // greedy: extend the line up to the last word that still fits
+        size_t n=0, brk=0;
+        int32_t pen=0;
+        for(; s[n] && s[n]!='\n'; ++n) {
+            const uint8_t *glyph;
+            uint32_t glyph_width;
+            if(!ssd1306_font_glyph(&f, s[n], &glyph, &glyph_width))
+                glyph_width=f.index?0:f.width;
+
+            if(n && (pen+(int32_t) glyph_width)*(int32_t) scale>(int32_t) width)
+                break;
+            if(s[n]==' ')
+                brk=n;
+
+            pen+=ssd1306_font_advance(&f, s[n], s[n+1]);
+        }
+
+        // split at the last space unless the line ended by itself, at a space (the whole line fits)
+        // or one word is wider than the rectangle
+        if(s[n] && s[n]!='\n' && s[n]!=' ' && brk)
+            n=brk;
+
+        ssd1306_draw_chars(p, x, line_y, scale, font, &f, s, n);
+
+        s+=n;
+        if(*s=='\n' || *s==' ')
+            ++s;
     }
+
+    p->clip_x0=clip[0];
+    p->clip_y0=clip[1];
+    p->clip_x1=clip[2];
+    p->clip_y1=clip[3];
+
+    while(*s==' ')
+        ++s;
+    return s;
 }
 
 void ssd1306_draw_char(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t scale, char c) {
@@ -241,6 +1193,18 @@ static inline uint32_t ssd1306_bmp_get_val(const uint8_t *data, const size_t off
     __builtin_unreachable();
 }
 
+// 8x8 bit matrix transpose: bit c of byte r becomes bit r of byte c
+inline static uint64_t ssd1306_transpose8(uint64_t m) {
+    uint64_t t;
+    t=(m^(m>>7))&0x00aa00aa00aa00aaull;
+    m^=t^(t<<7);
+    t=(m^(m>>14))&0x0000cccc0000ccccull;
+    m^=t^(t<<14);
+    t=(m^(m>>28))&0x00000000f0f0f0f0ull;
+    m^=t^(t<<28);
+    return m;
+}
+
 void ssd1306_bmp_show_image_with_offset(ssd1306_t *p, const uint8_t *data, const long size, uint32_t x_offset, uint32_t y_offset) {
     if(size<54) // data smaller than header
         return;
@@ -273,16 +1237,32 @@ void ssd1306_bmp_show_image_with_offset(ssd1306_t *p, const uint8_t *data, const
         bytes_per_line=(bytes_per_line^(bytes_per_line&3))+4;
 
     const uint8_t *img_data=data+bfOffBits;
+    const uint32_t rows=biHeight>0?biHeight:-biHeight;
+
+    // columns right of the display are never drawn
+    const uint32_t columns=biWidth<p->width?biWidth:p->width;
+    const uint8_t invert=color_val?0x00:0xff;
+
+    // 8 rows at a time: transpose each 8x8 block of source bits into 8 page bytes
+    uint8_t band[256];
+    for(uint32_t y=0; y<rows; y+=8) {
+        const uint32_t band_rows=rows-y<8?rows-y:8;
+        const uint8_t *line[8];
+        for(uint32_t j=0; j<band_rows; ++j)
+            line[j]=img_data+(biHeight>0?rows-1-(y+j):y+j)*bytes_per_line;
 
-    int32_t step=biHeight>0?-1:1;
-    int32_t border=biHeight>0?-1:-biHeight;
+        for(uint32_t bx=0; bx<<3<columns; ++bx) {
+            uint64_t m=0;
+            for(uint32_t j=0; j<band_rows; ++j)
+                m|=(uint64_t) (uint8_t) (line[j][bx]^invert)<<(j<<3);
+            m=ssd1306_transpose8(m);
 
-    for(uint32_t y=biHeight>0?biHeight-1:0; y!=(uint32_t)border; y+=step) {
-        for(uint32_t x=0; x<biWidth; ++x) {
-            if(((img_data[x>>3]>>(7-(x&7)))&1)==color_val)
-                ssd1306_draw_pixel(p, x_offset+x, y_offset+y);
+            // the leftmost pixel is the most significant bit
+            for(uint32_t c=0; c<8 && (bx<<3)+c<columns; ++c)
+                band[(bx<<3)+c]=m>>((7-c)<<3);
         }
-        img_data+=bytes_per_line;
+
+        ssd1306_blit_or(p, x_offset, y_offset+y, band, columns, band_rows, 1, 0);
     }
 }
 
@@ -290,17 +1270,350 @@ inline void ssd1306_bmp_show_image(ssd1306_t *p, const uint8_t *data, const long
     ssd1306_bmp_show_image_with_offset(p, data, size, 0, 0);
 }
 
+inline static void ssd1306_window_cmds(ssd1306_t *p, uint8_t *payload, uint32_t x0, uint32_t x1, uint32_t page0, uint32_t page1) {
+    const uint8_t col_offset=p->panel_width==64?32:0;
+
+    payload[0]=SET_COL_ADDR;
+    payload[1]=x0+col_offset;
+    payload[2]=x1+col_offset;
+    payload[3]=SET_PAGE_ADDR;
+    payload[4]=page0;
+    payload[5]=page1;
+}
+
+// panel image of a window: the buffer itself, or its 8x8 blocks transposed into p->rotated
+static uint8_t *ssd1306_panel_data(ssd1306_t *p, uint32_t x0, uint32_t x1, uint32_t page0, uint32_t page1) {
+    if(!p->rotated)
+        return ssd1306_frame(p);
+
+    const uint64_t start=time_us_64();
+    const uint8_t *src=ssd1306_frame(p);
+
+    // columns page*8.. of buffer page bx become columns bx*8.. of panel page page
+    // (little endian: byte k of the block is bits 8k..8k+7 of the word)
+    for(uint32_t page=page0; page<=page1; ++page) {
+        for(uint32_t bx=x0>>3; bx<=x1>>3; ++bx) {
+            uint64_t m;
+            memcpy(&m, src+bx*p->width+(page<<3), 8);
+            m=ssd1306_transpose8(m);
+            memcpy(p->rotated+page*p->panel_width+(bx<<3), &m, 8);
+        }
+    }
+
+    p->stats.rotate_us_total+=time_us_64()-start;
+    return p->rotated;
+}
+
+void ssd1306_show_window(ssd1306_t *p, uint32_t x0, uint32_t x1, uint32_t page0, uint32_t page1) {
+    uint8_t payload[6];
+    ssd1306_window_cmds(p, payload, x0, x1, page0, page1);
+
+    ssd1306_cmd_queue_n(p, payload, sizeof(payload));
+    ssd1306_cmd_flush(p);
+
+    uint8_t *data=ssd1306_panel_data(p, x0, x1, page0, page1);
+
+    // horizontal addressing wraps inside the window, full-width rows are contiguous in the buffer
+    if(x0==0 && x1==p->panel_width-1u) {
+        ssd1306_write_data(p, data+page0*p->panel_width, (page1-page0+1)*p->panel_width);
+        return;
+    }
+
+    for(uint32_t page=page0; page<=page1; ++page)
+        ssd1306_write_data(p, data+page*p->panel_width+x0, x1-x0+1);
+}
+
+// approximate bytes on wire spent to open another window (command transaction + data header)
+#define SSD1306_WINDOW_COST 10
+
+// page has changes that can be sent now (pages being scrolled by the panel are held back)
+inline static bool ssd1306_page_sendable(ssd1306_t *p, uint32_t page) {
+    return p->dirty_x0[page]<=p->dirty_x1[page] && !(p->scrolling && page>=p->scroll_page0 && page<=p->scroll_page1);
+}
+
+// rotated by 90 or 270: buffer page n is panel columns n*8..n*8+7, its changed columns are panel pages
+static bool ssd1306_next_window_rotated(ssd1306_t *p, uint32_t *page, uint32_t *x0, uint32_t *x1, uint32_t *page0, uint32_t *page1) {
+    while(*page<p->pages && p->dirty_x0[*page]>p->dirty_x1[*page])
+        ++(*page);
+
+    if(*page>=p->pages)
+        return false;
+
+    const uint32_t first=*page;
+    *page0=p->dirty_x0[*page]>>3;
+    *page1=p->dirty_x1[*page]>>3;
+    uint32_t used=*page1-*page0+1;
+
+    // same merging as below, in blocks of 8 bytes
+    for(uint32_t n=*page+1; n<p->pages && p->dirty_x0[n]<=p->dirty_x1[n]; ++n) {
+        const uint32_t np0=p->dirty_x0[n]>>3<*page0?p->dirty_x0[n]>>3:*page0;
+        const uint32_t np1=p->dirty_x1[n]>>3>*page1?p->dirty_x1[n]>>3:*page1;
+        const uint32_t nused=used+(p->dirty_x1[n]>>3)-(p->dirty_x0[n]>>3)+1;
+
+        if(((np1-np0+1)*(n+1-first)-nused)*8>SSD1306_WINDOW_COST)
+            break;
+
+        *page0=np0;
+        *page1=np1;
+        used=nused;
+        *page=n;
+    }
+
+    *x0=first<<3;
+    *x1=(*page<<3)+7;
+    ++(*page);
+    return true;
+}
+
+// finds the next window to send starting at buffer page *page, advances *page past it
+static bool ssd1306_next_window(ssd1306_t *p, uint32_t *page, uint32_t *x0, uint32_t *x1, uint32_t *page0, uint32_t *page1) {
+    if(p->rotated)
+        return ssd1306_next_window_rotated(p, page, x0, x1, page0, page1);
+
+    while(*page<p->pages && !ssd1306_page_sendable(p, *page))
+        ++(*page);
+
+    if(*page>=p->pages)
+        return false;
+
+    *page0=*page;
+    *x0=p->dirty_x0[*page];
+    *x1=p->dirty_x1[*page];
+    uint32_t used=*x1-*x0+1;
+
+    // merge following dirty pages into the same window while the bytes resent
+    // needlessly cost less than opening a new window
+    for(uint32_t n=*page+1; n<p->pages && ssd1306_page_sendable(p, n); ++n) {
+        const uint32_t nx0=p->dirty_x0[n]<*x0?p->dirty_x0[n]:*x0;
+        const uint32_t nx1=p->dirty_x1[n]>*x1?p->dirty_x1[n]:*x1;
+        const uint32_t nused=used+p->dirty_x1[n]-p->dirty_x0[n]+1;
+
+        if((nx1-nx0+1)*(n+1-*page0)-nused>SSD1306_WINDOW_COST)
+            break;
+
+        *x0=nx0;
+        *x1=nx1;
+        used=nused;
+        *page=n;
+    }
+
+    *page1=*page;
+    ++(*page);
+    return true;
+}
+
 void ssd1306_show(ssd1306_t *p) {
-    uint8_t payload[]= {SET_COL_ADDR, 0, p->width-1, SET_PAGE_ADDR, 0, p->pages-1};
-    if(p->width==64) {
-        payload[1]+=32;
-        payload[2]+=32;
+    // inside a frame the changes wait for ssd1306_end_frame
+    if(p->frame_depth)
+        return;
+
+    uint32_t page=0, x0, x1, page0, page1;
+    const uint64_t start=time_us_64();
+    bool sent=false;
+
+    while(ssd1306_next_window(p, &page, &x0, &x1, &page0, &page1)) {
+        ssd1306_show_window(p, x0, x1, page0, page1);
+        sent=true;
+    }
+
+    if(p->start_line_pending) {
+        ssd1306_cmd_queue(p, SET_DISP_START_LINE|p->start_line);
+        ssd1306_cmd_flush(p);
+        p->start_line_pending=false;
     }
 
-    for(size_t i=0; i<sizeof(payload); ++i)
-        ssd1306_write(p, payload[i]);
+    if(sent)
+        ssd1306_stats_flush(p, start);
+    ssd1306_mark_clean(p);
+}
 
-    *(p->buffer-1)=0x40;
+inline void ssd1306_begin_frame(ssd1306_t *p) {
+    ++p->frame_depth;
+}
+
+void ssd1306_end_frame(ssd1306_t *p) {
+    if(p->frame_depth && --p->frame_depth)
+        return;
 
-    fancy_write(p->i2c_i, p->address, p->buffer-1, p->bufsize+1, "ssd1306_show");
+    if(!p->frame_async) {
+        ssd1306_show(p);
+        return;
+    }
+
+    // the deferred ssd1306_show_async, after the flush of a previous frame
+    p->frame_async=false;
+    ssd1306_flush_wait(p);
+    if(ssd1306_show_async(p, p->frame_cb, p->frame_arg))
+        return;
+
+    // no memory for a background transfer
+    ssd1306_show(p);
+    if(p->frame_cb)
+        p->frame_cb(p, true, p->frame_arg);
+}
+
+// appends one transaction to the background transfer, chained to the previous one by a repeated start
+inline static void ssd1306_tx_append(ssd1306_t *p, uint8_t control, const uint8_t *src, size_t len) {
+    uint16_t *w=p->tx+p->tx_len;
+
+    *w++=control|(p->tx_len?I2C_IC_DATA_CMD_RESTART_BITS:0);
+    for(size_t i=0; i<len; ++i)
+        *w++=src[i];
+
+    p->tx_len+=len+1;
+}
+
+bool ssd1306_show_async(ssd1306_t *p, ssd1306_flush_cb_t cb, void *arg) {
+    // inside a frame: started by ssd1306_end_frame, a flush still running does not matter yet
+    if(p->frame_depth) {
+        if(p->frame_async)
+            return false;
+        p->frame_async=true;
+        p->frame_cb=cb;
+        p->frame_arg=arg;
+        return true;
+    }
+
+    if(p->busy)
+        return false;
+
+    // worst case: every buffer page in its own window of up to all panel pages, then the start line command
+    if(!p->tx && (p->tx=malloc(SSD1306_TX_WORDS(p->panel_width, p->panel_pages<<3)*sizeof(uint16_t)))==NULL)
+        return false;
+
+    uint32_t page=0, x0, x1, page0, page1;
+    uint8_t payload[6];
+
+    // counted once the transfer is started, the blocking fallback counts itself
+    uint32_t transactions=0, data_bytes=0;
+
+    p->tx_len=0;
+    while(ssd1306_next_window(p, &page, &x0, &x1, &page0, &page1)) {
+        ssd1306_window_cmds(p, payload, x0, x1, page0, page1);
+        ssd1306_tx_append(p, 0x00, payload, sizeof(payload));
+
+        const uint8_t *data=ssd1306_panel_data(p, x0, x1, page0, page1);
+        for(uint32_t pg=page0; pg<=page1; ++pg)
+            ssd1306_tx_append(p, 0x40, data+pg*p->panel_width+x0, x1-x0+1);
+
+        transactions+=2+page1-page0;
+        data_bytes+=(page1-page0+1)*(x1-x0+1);
+    }
+
+    // rows drawn for a vertical scroll are in place before the panel shows them
+    const bool start_line=p->start_line_pending;
+    if(start_line) {
+        const uint8_t cmd=SET_DISP_START_LINE|p->start_line;
+        ssd1306_tx_append(p, 0x00, &cmd, 1);
+        ++transactions;
+        p->start_line_pending=false;
+    }
+
+    if(!p->tx_len) {
+        if(cb)
+            cb(p, true, arg);
+        return true;
+    }
+
+    p->tx[p->tx_len-1]|=I2C_IC_DATA_CMD_STOP_BITS;
+
+    // the spans are captured in tx, later drawing marks new ones
+    uint8_t dirty_x0[SSD1306_MAX_PAGES], dirty_x1[SSD1306_MAX_PAGES];
+    memcpy(dirty_x0, p->dirty_x0, sizeof(dirty_x0));
+    memcpy(dirty_x1, p->dirty_x1, sizeof(dirty_x1));
+    ssd1306_mark_clean(p);
+
+    p->done_cb=cb;
+    p->done_arg=arg;
+    p->flush_start=time_us_64();
+    p->busy=true;
+
+    if(!p->transport->start || !p->transport->start(p, p->tx, p->tx_len)) {
+        // no background transfer available, fall back to blocking flush
+        p->busy=false;
+        memcpy(p->dirty_x0, dirty_x0, sizeof(dirty_x0));
+        memcpy(p->dirty_x1, dirty_x1, sizeof(dirty_x1));
+        p->start_line_pending=start_line;
+        ssd1306_show(p);
+        if(cb)
+            cb(p, true, arg);
+        return true;
+    }
+
+    // the transfer may already be done, ssd1306_async_done only accounts for the time
+    p->stats.transactions+=transactions;
+    p->stats.bytes+=p->tx_len;
+    p->stats.data_bytes+=data_bytes;
+    p->stats.command_bytes+=p->tx_len-transactions-data_bytes;
+
+    return true;
+}
+
+void ssd1306_async_done(ssd1306_t *p, bool ok) {
+    if(!ok)
+        ++p->stats.aborts;
+    ssd1306_stats_flush(p, p->flush_start);
+    p->busy=false;
+
+    if(p->done_cb)
+        p->done_cb(p, ok, p->done_arg);
+}
+
+inline bool ssd1306_flush_busy(ssd1306_t *p) {
+    return p->busy;
+}
+
+void ssd1306_flush_wait(ssd1306_t *p) {
+    while(p->busy)
+        tight_loop_contents();
+}
+
+void ssd1306_stats_get(ssd1306_t *p, ssd1306_stats_t *stats) {
+    // a background flush may complete in between
+    const uint32_t irq=save_and_disable_interrupts();
+    *stats=p->stats;
+    restore_interrupts(irq);
+}
+
+void ssd1306_stats_reset(ssd1306_t *p) {
+    const uint32_t irq=save_and_disable_interrupts();
+    memset(&p->stats, 0, sizeof(p->stats));
+    restore_interrupts(irq);
+
+    p->stats_dumped=time_us_64();
+}
+
+void ssd1306_stats_dump(ssd1306_t *p, const char *name) {
+    ssd1306_stats_t s;
+    ssd1306_stats_get(p, &s);
+
+    printf("[%s] %lu flushes, %lu transactions, %lu bytes (%lu command, %lu data), %lu nacks, %lu timeouts, %lu aborts\n",
+           name, (unsigned long) s.flushes, (unsigned long) s.transactions, (unsigned long) s.bytes,
+           (unsigned long) s.command_bytes, (unsigned long) s.data_bytes,
+           (unsigned long) s.nacks, (unsigned long) s.timeouts, (unsigned long) s.aborts);
+
+    if(!s.flushes)
+        return;
+
+    printf("[%s] flush avg %lu us, max %lu us, <us:count", name,
+           (unsigned long) (s.flush_us_total/s.flushes), (unsigned long) s.flush_us_max);
+    for(uint32_t i=0; i<SSD1306_STATS_BUCKETS; ++i)
+        if(s.flush_us_hist[i])
+            printf(" %s%lu:%lu", i==SSD1306_STATS_BUCKETS-1?">=":"<",
+                   (unsigned long) (i==SSD1306_STATS_BUCKETS-1?1ul<<(i-1):1ul<<i), (unsigned long) s.flush_us_hist[i]);
+    printf("\n");
+
+    // cost of rotating by 90 or 270, compare with the flush time above
+    if(s.rotate_us_total)
+        printf("[%s] rotate avg %lu us per flush\n", name, (unsigned long) (s.rotate_us_total/s.flushes));
+}
+
+bool ssd1306_stats_dump_every(ssd1306_t *p, const char *name, uint32_t interval_ms) {
+    const uint64_t now=time_us_64();
+    if(now-p->stats_dumped<(uint64_t) interval_ms*1000)
+        return false;
+
+    p->stats_dumped=now;
+    ssd1306_stats_dump(p, name);
+    return true;
 }
@@ -33,6 +33,36 @@ SOFTWARE.
 #include <pico/stdlib.h>
 #include <hardware/i2c.h>
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+*	@brief maximum number of pages tracked per display (128 rows of a 128x64 panel rotated by 90 / 8)
+*/
+#define SSD1306_MAX_PAGES 16
+
+/**
+*	@brief maximum number of command bytes queued before the batch is sent
+*/
+#define SSD1306_CMD_BATCH_MAX 32
+
+/**
+*	@brief bytes of the buffer given to ssd1306_init_static: the frame plus one byte in front of it
+*/
+#define SSD1306_BUFFER_SIZE(width, height) ((width)*((height)/8)+1)
+
+/**
+*	@brief IC_DATA_CMD words of a background flush in the worst case: every buffer page in its own
+*	window of up to all panel pages, then the start line command
+*/
+#define SSD1306_TX_WORDS(width, height) ((width)*((height)/8)+SSD1306_MAX_PAGES*((height)/8+7)+2)
+
+/**
+*	@brief number of flush duration histogram buckets, bucket n counts flushes of [2^(n-1), 2^n) us
+*/
+#define SSD1306_STATS_BUCKETS 20
+
 /**
 *	@brief defines commands used in ssd1306
 */
@@ -53,21 +83,118 @@ typedef enum {
     SET_DISP_CLK_DIV = 0xD5,
     SET_PRECHARGE = 0xD9,
     SET_VCOM_DESEL = 0xDB,
-    SET_CHARGE_PUMP = 0x8D
+    SET_CHARGE_PUMP = 0x8D,
+    SET_HSCROLL_RIGHT = 0x26,
+    SET_HSCROLL_LEFT = 0x27,
+    SET_VHSCROLL_RIGHT = 0x29,
+    SET_VHSCROLL_LEFT = 0x2A,
+    SET_SCROLL_OFF = 0x2E,
+    SET_SCROLL_ON = 0x2F,
+    SET_VSCROLL_AREA = 0xA3
 } ssd1306_command_t;
 
+struct ssd1306;
+
 /**
-*	@brief holds the configuration
+*	@brief called when a background flush finished, runs in interrupt context
+
+	@param[in] p : instance of display
+	@param[in] ok : false if the transfer was aborted (e.g. address not acknowledged)
+	@param[in] arg : user argument given to ssd1306_show_async
+*/
+typedef void (*ssd1306_flush_cb_t)(struct ssd1306 *p, bool ok, void *arg);
+
+/**
+*	@brief bus access used by the driver, replaceable e.g. by a host mock
+*/
+typedef struct {
+    /** blocking write of one transaction, returns bytes written or PICO_ERROR_GENERIC/PICO_ERROR_TIMEOUT */
+    int (*write)(struct ssd1306 *p, const uint8_t *src, size_t len);
+    /** start background transfer of IC_DATA_CMD words (byte | RESTART/STOP bits), returns false if not possible.
+        completion must be reported with ssd1306_async_done */
+    bool (*start)(struct ssd1306 *p, const uint16_t *words, size_t len);
+} ssd1306_transport_t;
+
+/**
+*	@brief default transport: i2c_write_blocking and DMA into the i2c TX FIFO
+*/
+extern const ssd1306_transport_t ssd1306_i2c_transport;
+
+/**
+*	@brief bus statistics, see ssd1306_stats_get
 */
 typedef struct {
+    uint32_t transactions;	/**< i2c transactions started */
+    uint32_t bytes;			/**< bytes after the address byte, control bytes included */
+    uint32_t command_bytes;	/**< command bytes */
+    uint32_t data_bytes;	/**< display RAM bytes */
+    uint32_t nacks;			/**< blocking writes not acknowledged */
+    uint32_t timeouts;		/**< blocking writes timed out */
+    uint32_t aborts;		/**< background flushes aborted */
+    uint32_t flushes;		/**< ssd1306_show/ssd1306_show_async calls that sent something */
+    uint32_t flush_us_max;	/**< longest flush */
+    uint64_t flush_us_total;	/**< time spent in flushes */
+    uint64_t rotate_us_total;	/**< time spent rotating the buffer for flushes, see ssd1306_set_rotation */
+    uint32_t flush_us_hist[SSD1306_STATS_BUCKETS];	/**< flushes by duration, log2 us buckets */
+} ssd1306_stats_t;
+
+/**
+*	@brief orientation of the drawing coordinates on the panel, clockwise
+*/
+typedef enum {
+    SSD1306_ROTATE_0=0,
+    SSD1306_ROTATE_90,
+    SSD1306_ROTATE_180,
+    SSD1306_ROTATE_270,
+} ssd1306_rotation_t;
+
+/**
+*	@brief holds the configuration
+*/
+typedef struct ssd1306 {
     uint8_t width; 		/**< width of display */
     uint8_t height; 	/**< height of display */
     uint8_t pages;		/**< stores pages of display (calculated on initialization*/
+    uint8_t panel_width;	/**< width of the panel, width and height are swapped when rotated by 90 or 270 */
+    uint8_t panel_pages;	/**< pages of the panel */
+    ssd1306_rotation_t rotation;	/**< see ssd1306_set_rotation */
+    bool mirror;		/**< drawing mirrored left to right */
+    uint8_t *rotated;	/**< panel image of the buffer when rotated by 90 or 270, NULL otherwise */
     uint8_t address; 	/**< i2c address of display*/
     i2c_inst_t *i2c_i; 	/**< i2c connection instance */
     bool external_vcc; 	/**< whether display uses external vcc */ 
-    uint8_t *buffer;	/**< display buffer */
+    uint8_t *buffer;	/**< display buffer, drawing goes here */
+    bool static_buffer;	/**< buffer given to ssd1306_init_static, not freed by ssd1306_deinit */
+    uint8_t *front;		/**< buffer being displayed when double buffered, NULL otherwise */
+    bool diff_on_swap;	/**< whether ssd1306_swap compares both buffers to find changed spans */
+    uint8_t clip_x0;	/**< first column drawing functions may touch */
+    uint8_t clip_y0;	/**< first row drawing functions may touch */
+    uint8_t clip_x1;	/**< column after the clip area */
+    uint8_t clip_y1;	/**< row after the clip area */
     size_t bufsize;		/**< buffer size */
+    uint8_t dirty_x0[SSD1306_MAX_PAGES];	/**< first changed column per page (dirty_x0>dirty_x1: page clean) */
+    uint8_t dirty_x1[SSD1306_MAX_PAGES];	/**< last changed column per page */
+    uint8_t cmds[SSD1306_CMD_BATCH_MAX+1];	/**< queued commands, cmds[0] is reserved for the control byte */
+    uint8_t cmd_len;	/**< number of queued commands */
+    const ssd1306_transport_t *transport;	/**< bus access, set by initialization */
+    uint16_t *tx;		/**< IC_DATA_CMD words of background flush (allocated on first ssd1306_show_async) */
+    size_t tx_len;		/**< number of words in tx */
+    bool static_tx;		/**< tx given to ssd1306_init_static, not freed by ssd1306_deinit */
+    volatile bool busy;	/**< background flush in progress */
+    ssd1306_flush_cb_t done_cb;	/**< completion callback of background flush */
+    void *done_arg;		/**< argument of done_cb */
+    uint64_t flush_start;	/**< time_us_64 when the background flush started */
+    ssd1306_stats_t stats;	/**< bus statistics */
+    uint64_t stats_dumped;	/**< time_us_64 of the last ssd1306_stats_dump_every output */
+    bool scrolling;		/**< continuous scroll running, pages scroll_page0..scroll_page1 are not sent */
+    uint8_t scroll_page0;	/**< first page moved by the panel */
+    uint8_t scroll_page1;	/**< last page moved by the panel */
+    uint8_t start_line;	/**< display RAM row shown on top */
+    bool start_line_pending;	/**< start_line is sent after the data of the next flush */
+    uint8_t frame_depth;	/**< nesting of ssd1306_begin_frame, flushes are held back while not 0 */
+    bool frame_async;	/**< ssd1306_show_async was called inside the frame */
+    ssd1306_flush_cb_t frame_cb;	/**< its callback, run when the flush at ssd1306_end_frame completes */
+    void *frame_arg;	/**< argument of frame_cb */
 } ssd1306_t;
 
 /**
@@ -85,6 +212,43 @@ typedef struct {
 */
 bool ssd1306_init(ssd1306_t *p, uint16_t width, uint16_t height, uint8_t address, i2c_inst_t *i2c_instance);
 
+/**
+*	@brief initialize display with caller provided storage, no heap is used
+*
+*	@param[in] p : pointer to instance of ssd1306_t
+*	@param[in] width : width of display
+*	@param[in] height : heigth of display
+*	@param[in] address : i2c address of display
+*	@param[in] i2c_instance : instance of i2c connection
+*	@param[in] buffer : SSD1306_BUFFER_SIZE(width, height) bytes, e.g. a static array
+*	@param[in] tx : SSD1306_TX_WORDS(width, height) words for ssd1306_show_async, NULL to allocate on first use
+*
+* 	@return bool.
+*	@retval true for Success
+*	@retval false if the display has more than SSD1306_MAX_PAGES pages
+*/
+bool ssd1306_init_static(ssd1306_t *p, uint16_t width, uint16_t height, uint8_t address, i2c_inst_t *i2c_instance, uint8_t *buffer, uint16_t *tx);
+
+/**
+*	@brief initialize display on another bus access than ssd1306_i2c_transport, e.g. a host mock
+*
+*	every field of p is set here, it need not be zeroed before
+*
+*	@param[in] p : pointer to instance of ssd1306_t
+*	@param[in] transport : bus access, NULL for ssd1306_i2c_transport; the init sequence goes through it
+*	@param[in] width : width of display
+*	@param[in] height : heigth of display
+*	@param[in] address : i2c address of display
+*	@param[in] i2c_instance : instance of i2c connection
+*	@param[in] buffer : SSD1306_BUFFER_SIZE(width, height) bytes, NULL to allocate
+*	@param[in] tx : SSD1306_TX_WORDS(width, height) words for ssd1306_show_async, NULL to allocate on first use
+*
+* 	@return bool.
+*	@retval true for Success
+*	@retval false if the buffer could not be allocated or the display has more than SSD1306_MAX_PAGES pages
+*/
+bool ssd1306_init_transport(ssd1306_t *p, const ssd1306_transport_t *transport, uint16_t width, uint16_t height, uint8_t address, i2c_inst_t *i2c_instance, uint8_t *buffer, uint16_t *tx);
+
 /**
 *	@brief deinitialize display
 *
@@ -127,14 +291,281 @@ void ssd1306_contrast(ssd1306_t *p, uint8_t val);
 */
 void ssd1306_invert(ssd1306_t *p, uint8_t inv);
 
+/**
+	@brief set orientation of the drawing coordinates
+
+	180 degrees and mirroring are done by the panel (SEG remap, COM scan direction) at no cost.
+	for 90 and 270 degrees width and height swap (a 128x64 panel becomes 64x128) and every flush
+	rotates the changed 8x8 blocks of the buffer, which takes far less time than sending them.
+	the buffer is cleared and sent completely on the next flush. hardware scrolling is not
+	available while rotated by 90 or 270
+
+	@param[in] p : instance of display
+	@param[in] rotation : clockwise rotation of the image on the panel
+	@param[in] mirror : mirror the image left to right (before rotating)
+
+	@return false if out of memory, the orientation is unchanged then
+*/
+bool ssd1306_set_rotation(ssd1306_t *p, ssd1306_rotation_t rotation, bool mirror);
+
+/**
+	@brief start continuous horizontal scrolling of pages page0..page1
+
+	the panel moves the pages by itself, wrapping columns around, without any bus traffic.
+	pending changes are sent first (blocking); while scrolling, changes to the pages are kept
+	back until ssd1306_scroll_stop
+
+	@param[in] p : instance of display
+	@param[in] page0 : first page (rows page0*8..)
+	@param[in] page1 : last page
+	@param[in] left : true: content moves left, false: right
+	@param[in] frames : panel frames per column step, rounded to 2, 3, 4, 5, 25, 64, 128 or 256
+*/
+void ssd1306_scroll_horizontal(ssd1306_t *p, uint32_t page0, uint32_t page1, bool left, uint32_t frames);
+
+/**
+	@brief start continuous diagonal scrolling: pages page0..page1 move sideways, the rows
+	area_top..area_top+area_rows-1 move up by vertical_offset rows per step
+
+	all pages are kept back until ssd1306_scroll_stop
+
+	@param[in] p : instance of display
+	@param[in] page0 : first page scrolling horizontally
+	@param[in] page1 : last page scrolling horizontally
+	@param[in] left : true: content moves left, false: right
+	@param[in] frames : panel frames per step, see ssd1306_scroll_horizontal
+	@param[in] vertical_offset : rows per step, 1..63
+	@param[in] area_top : first row of the vertical scroll area
+	@param[in] area_rows : rows in the vertical scroll area
+*/
+void ssd1306_scroll_diagonal(ssd1306_t *p, uint32_t page0, uint32_t page1, bool left, uint32_t frames, uint32_t vertical_offset, uint32_t area_top, uint32_t area_rows);
+
+/**
+	@brief stop continuous scrolling
+
+	the panel RAM of the scrolled pages no longer matches the buffer, they are sent again on
+	the next flush
+
+	@param[in] p : instance of display
+*/
+void ssd1306_scroll_stop(ssd1306_t *p);
+
+/**
+	@brief move the displayed rows by changing the display start line
+
+	only 64 row displays not rotated by 90 or 270: the panel shows buffer rows starting at the
+	start line, wrapping at 64.
+	the change is sent after the data of the next flush, so rows drawn for the newly exposed
+	part appear together with it
+
+	@param[in] p : instance of display
+	@param[in] lines : rows the content moves up (negative: down)
+
+	@return buffer row where the newly exposed rows start (at the bottom for lines>0, at the top
+	        for lines<0); |lines| rows from there, wrapping at 64, should be redrawn
+*/
+uint32_t ssd1306_scroll_vertical(ssd1306_t *p, int32_t lines);
+
+/**
+	@brief buffer row shown at a display row, see ssd1306_scroll_vertical
+
+	@param[in] p : instance of display
+	@param[in] y : row on the display
+
+	@return row in the buffer
+*/
+uint32_t ssd1306_ram_row(ssd1306_t *p, uint32_t y);
+
 /**
 	@brief display buffer, should be called on change
 
+	only the page/column spans changed since the last call are transmitted
+
 	@param[in] p : instance of display
 
 */
 void ssd1306_show(ssd1306_t *p);
 
+/**
+	@brief start a frame: ssd1306_show and ssd1306_show_async do nothing until the matching
+	ssd1306_end_frame, so helpers that draw and show can be combined into one flush
+
+	frames nest, only the outermost ssd1306_end_frame flushes
+
+	@param[in] p : instance of display
+*/
+void ssd1306_begin_frame(ssd1306_t *p);
+
+/**
+	@brief end a frame, the outermost one sends everything changed inside it: in the background
+	if ssd1306_show_async was called in the frame, with ssd1306_show otherwise
+
+	@param[in] p : instance of display
+*/
+void ssd1306_end_frame(ssd1306_t *p);
+
+/**
+	@brief send columns x0..x1 of pages page0..page1 from buffer
+
+	programs the address window with one command transaction followed by the data.
+	columns and pages are those of the panel, see ssd1306_set_rotation
+
+	@param[in] p : instance of display
+	@param[in] x0 : first column
+	@param[in] x1 : last column
+	@param[in] page0 : first page
+	@param[in] page1 : last page
+*/
+void ssd1306_show_window(ssd1306_t *p, uint32_t x0, uint32_t x1, uint32_t page0, uint32_t page1);
+
+/**
+	@brief queue command byte, the queue is sent when full or on ssd1306_cmd_flush
+
+	@param[in] p : instance of display
+	@param[in] cmd : command or command argument
+*/
+void ssd1306_cmd_queue(ssd1306_t *p, uint8_t cmd);
+
+/**
+	@brief queue several command bytes
+
+	@param[in] p : instance of display
+	@param[in] cmds : commands and their arguments
+	@param[in] len : number of bytes
+*/
+void ssd1306_cmd_queue_n(ssd1306_t *p, const uint8_t *cmds, size_t len);
+
+/**
+	@brief send queued commands as one i2c transaction
+
+	@param[in] p : instance of display
+
+*/
+void ssd1306_cmd_flush(ssd1306_t *p);
+
+/**
+	@brief start sending changed spans of buffer in the background and return immediately
+
+	the changed spans are copied when called, drawing may continue during the transfer.
+	blocking calls (ssd1306_show, commands) wait for the transfer to finish.
+
+	inside a frame (ssd1306_begin_frame) nothing is sent: the outermost ssd1306_end_frame
+	starts the background flush instead and cb runs when that completes. one call per frame
+
+	@param[in] p : instance of display
+	@param[in] cb : called on completion (interrupt context), may be NULL
+	@param[in] arg : passed to cb
+
+	@return bool.
+	@retval true if the flush was started, completed or deferred to the end of the frame
+	@retval false if a flush is still in progress, no memory is available or a flush is
+	        deferred to the end of the frame already
+*/
+bool ssd1306_show_async(ssd1306_t *p, ssd1306_flush_cb_t cb, void *arg);
+
+/**
+	@brief check whether a background flush is in progress
+
+	@param[in] p : instance of display
+*/
+bool ssd1306_flush_busy(ssd1306_t *p);
+
+/**
+	@brief wait until background flush finished
+
+	@param[in] p : instance of display
+
+*/
+void ssd1306_flush_wait(ssd1306_t *p);
+
+/**
+	@brief report end of background transfer, called by the transport
+
+	@param[in] p : instance of display
+	@param[in] ok : false if transfer was aborted
+*/
+void ssd1306_async_done(ssd1306_t *p, bool ok);
+
+/**
+	@brief copy the bus statistics
+
+	@param[in] p : instance of display
+	@param[out] stats : counters since initialization or the last ssd1306_stats_reset
+*/
+void ssd1306_stats_get(ssd1306_t *p, ssd1306_stats_t *stats);
+
+/**
+	@brief zero the bus statistics
+
+	@param[in] p : instance of display
+*/
+void ssd1306_stats_reset(ssd1306_t *p);
+
+/**
+	@brief print the bus statistics
+
+	@param[in] p : instance of display
+	@param[in] name : prefix of the output lines
+*/
+void ssd1306_stats_dump(ssd1306_t *p, const char *name);
+
+/**
+	@brief print the bus statistics if interval_ms passed since the last time, call from the main loop
+
+	@param[in] p : instance of display
+	@param[in] name : prefix of the output lines
+	@param[in] interval_ms : time between outputs
+
+	@return true if printed
+*/
+bool ssd1306_stats_dump_every(ssd1306_t *p, const char *name, uint32_t interval_ms);
+
+/**
+	@brief enable double buffering
+
+	drawing goes to p->buffer while flushes read the front buffer. after ssd1306_swap
+	p->buffer holds the frame before the swapped one and has to be redrawn.
+	drawing functions stop tracking changed spans, ssd1306_swap computes them instead.
+
+	@param[in] p : instance of display
+	@param[in] diff_on_swap : true: only pages/columns differing between the buffers are sent,
+	                          false: every swap sends the whole frame
+
+	@return bool.
+	@retval true for Success
+	@retval false if no memory for the front buffer is available
+*/
+bool ssd1306_double_buffer(ssd1306_t *p, bool diff_on_swap);
+
+/**
+	@brief exchange front and back buffer, the next ssd1306_show displays what was drawn
+
+	@param[in] p : instance of display
+
+*/
+void ssd1306_swap(ssd1306_t *p);
+
+/**
+	@brief mark area of buffer as changed
+
+	needed only when p->buffer is written directly instead of through the drawing functions
+
+	@param[in] p : instance of display
+	@param[in] x : x position of starting point
+	@param[in] y : y position of starting point
+	@param[in] width : width of area
+	@param[in] height : height of area
+*/
+void ssd1306_mark_dirty(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height);
+
+/**
+	@brief mark whole buffer as changed, next ssd1306_show transmits the full frame
+
+	@param[in] p : instance of display
+
+*/
+void ssd1306_invalidate(ssd1306_t *p);
+
 /**
 	@brief clear display buffer
 
@@ -172,6 +603,26 @@ void ssd1306_draw_pixel(ssd1306_t *p, uint32_t x, uint32_t y);
 */
 void ssd1306_draw_line(ssd1306_t *p, int32_t x1, int32_t y1, int32_t x2, int32_t y2);
 
+/**
+	@brief draw horizontal line on buffer, clipped to display
+
+	@param[in] p : instance of display
+	@param[in] x : x position of starting point
+	@param[in] y : y position of line
+	@param[in] width : length of line
+*/
+void ssd1306_draw_hline(ssd1306_t *p, int32_t x, int32_t y, int32_t width);
+
+/**
+	@brief draw vertical line on buffer, clipped to display
+
+	@param[in] p : instance of display
+	@param[in] x : x position of line
+	@param[in] y : y position of starting point
+	@param[in] height : length of line
+*/
+void ssd1306_draw_vline(ssd1306_t *p, int32_t x, int32_t y, int32_t height);
+
 /**
 	@brief clear square at given position with given size
 
@@ -194,6 +645,53 @@ void ssd1306_clear_square(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width,
 */
 void ssd1306_draw_square(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height);
 
+/**
+	@brief fill rectangle, clipped to display
+
+	whole page bytes are written per column run instead of single pixels
+
+	@param[in] p : instance of display
+	@param[in] x : x position of starting point
+	@param[in] y : y position of starting point
+	@param[in] width : width of rectangle
+	@param[in] height : height of rectangle
+*/
+void ssd1306_fill_rect(ssd1306_t *p, int32_t x, int32_t y, uint32_t width, uint32_t height);
+
+/**
+	@brief clear rectangle, clipped to display
+
+	@param[in] p : instance of display
+	@param[in] x : x position of starting point
+	@param[in] y : y position of starting point
+	@param[in] width : width of rectangle
+	@param[in] height : height of rectangle
+*/
+void ssd1306_clear_rect(ssd1306_t *p, int32_t x, int32_t y, uint32_t width, uint32_t height);
+
+/**
+	@brief invert pixels of rectangle, clipped to display
+
+	@param[in] p : instance of display
+	@param[in] x : x position of starting point
+	@param[in] y : y position of starting point
+	@param[in] width : width of rectangle
+	@param[in] height : height of rectangle
+*/
+void ssd1306_invert_rect(ssd1306_t *p, int32_t x, int32_t y, uint32_t width, uint32_t height);
+
+/**
+	@brief xor rectangle with a vertical pattern, clipped to display
+
+	@param[in] p : instance of display
+	@param[in] x : x position of starting point
+	@param[in] y : y position of starting point
+	@param[in] width : width of rectangle
+	@param[in] height : height of rectangle
+	@param[in] pattern : bit n is applied to rows with y%8==n (0xff inverts, 0x55 every other row)
+*/
+void ssd1306_xor_rect(ssd1306_t *p, int32_t x, int32_t y, uint32_t width, uint32_t height, uint8_t pattern);
+
 /**
 	@brief draw empty square at given position with given size
 
@@ -205,6 +703,25 @@ void ssd1306_draw_square(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, u
 */
 void ssd1306_draw_empty_square(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height);
 
+/**
+	@brief restrict drawing to a rectangle (ssd1306_clear is not affected)
+
+	@param[in] p : instance of display
+	@param[in] x : x position of starting point
+	@param[in] y : y position of starting point
+	@param[in] width : width of clip area
+	@param[in] height : height of clip area
+*/
+void ssd1306_set_clip(ssd1306_t *p, int32_t x, int32_t y, uint32_t width, uint32_t height);
+
+/**
+	@brief allow drawing on the whole display again
+
+	@param[in] p : instance of display
+
+*/
+void ssd1306_reset_clip(ssd1306_t *p);
+
 /**
 	@brief draw monochrome bitmap with offset
 
@@ -271,4 +788,43 @@ void ssd1306_draw_string_with_font(ssd1306_t *p, uint32_t x, uint32_t y, uint32_
 */
 void ssd1306_draw_string(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t scale, const char *s);
 
+/**
+	@brief height of a text line
+
+	@param[in] font : pointer to font
+	@param[in] scale : scale font to n times of original size (default should be 1)
+*/
+uint32_t ssd1306_font_height(const uint8_t *font, uint32_t scale);
+
+/**
+	@brief width of text in pixels, including kerning and without spacing after the last char
+
+	@param[in] font : pointer to font
+	@param[in] scale : scale font to n times of original size (default should be 1)
+	@param[in] s : text to measure
+*/
+uint32_t ssd1306_measure_string(const uint8_t *font, uint32_t scale, const char *s);
+
+/**
+	@brief draw text into a rectangle, wrapping lines at spaces and '\n'
+
+	words wider than the rectangle are split, nothing is drawn outside of it
+
+	@param[in] p : instance of display
+	@param[in] x : x position of rectangle
+	@param[in] y : y position of rectangle
+	@param[in] width : width of rectangle
+	@param[in] height : height of rectangle
+	@param[in] scale : scale font to n times of original size (default should be 1)
+	@param[in] font : pointer to font
+	@param[in] s : text to draw
+
+	@return remaining text that did not fit (empty string if everything was drawn)
+*/
+const char *ssd1306_draw_string_wrapped(ssd1306_t *p, int32_t x, int32_t y, uint32_t width, uint32_t height, uint32_t scale, const uint8_t *font, const char *s);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif
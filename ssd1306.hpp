@@ -0,0 +1,227 @@
+/**
+* @file ssd1306.hpp
+*
+* C++17 front end of the ssd1306 driver for a panel size known at compile time
+*
+* the frame buffer and the background flush buffer are members, so a static instance needs no
+* heap and cannot fail to allocate at boot. pixel and rectangle drawing is inlined with the
+* geometry as constants: the row stride is a shift, the page count and bounds are immediates.
+* everything else (text, bitmaps, scrolling, statistics) is the C API on c(), which works on the
+* same buffer and dirty spans
+*
+*   static Ssd1306<128, 64> oled;
+*   oled.init(0x3c, i2c1);
+*   oled.fill_rect(0, 0, 10, 10);
+*   ssd1306_draw_string(oled.c(), 0, 16, 1, "hello");
+*   oled.show();
+*
+* ssd1306_set_rotation by 90 or 270 swaps width and height and does not fit the fixed geometry,
+* 180 degrees and mirroring do
+*/
+
+#ifndef _inc_ssd1306_hpp
+#define _inc_ssd1306_hpp
+
+#include <cstdint>
+#include <cstring>
+
+#include "ssd1306.h"
+
+template<uint8_t Width, uint8_t Height, const ssd1306_transport_t *Transport=&ssd1306_i2c_transport>
+class Ssd1306 {
+    static_assert(Width>=8 && Width<=128, "panel width out of range");
+    static_assert(Height>=8 && Height<=8*SSD1306_MAX_PAGES && Height%8==0, "panel height must be a multiple of 8");
+
+public:
+    static constexpr uint32_t width=Width;			/**< width of display */
+    static constexpr uint32_t height=Height;		/**< height of display */
+    static constexpr uint32_t pages=Height/8;		/**< pages of display */
+    static constexpr size_t bufsize=Width*pages;	/**< buffer size */
+
+    /**
+    	@brief initialize display on Transport, see ssd1306_init_transport
+
+    	@param[in] address : i2c address of display
+    	@param[in] i2c_instance : instance of i2c connection
+
+    	@return true on success
+    */
+    bool init(uint8_t address, i2c_inst_t *i2c_instance) {
+        return ssd1306_init_transport(&dev, Transport, Width, Height, address, i2c_instance, storage, tx);
+    }
+
+    /**
+    	@brief deinitialize display, waits for a background flush
+    */
+    void deinit() {
+        ssd1306_deinit(&dev);
+    }
+
+    /**
+    	@brief instance for the C functions
+    */
+    ssd1306_t *c() {
+        return &dev;
+    }
+
+    /**
+    	@brief display buffer, page by page
+    */
+    uint8_t *buffer() {
+        return storage+1;
+    }
+
+    /**
+    	@brief draw pixel on buffer, outside of the clip area is ignored
+
+    	@param[in] x : x position
+    	@param[in] y : y position
+    */
+    void draw_pixel(uint32_t x, uint32_t y) {
+        update<Op::set>(x, y);
+    }
+
+    /**
+    	@brief clear pixel on buffer, outside of the clip area is ignored
+
+    	@param[in] x : x position
+    	@param[in] y : y position
+    */
+    void clear_pixel(uint32_t x, uint32_t y) {
+        update<Op::clear>(x, y);
+    }
+
+    /**
+    	@brief whether the pixel is set in the buffer
+
+    	@param[in] x : x position
+    	@param[in] y : y position
+    */
+    bool get_pixel(uint32_t x, uint32_t y) const {
+        return x<Width && y<Height && storage[1+x+Width*(y>>3)]>>(y&0x07)&1;
+    }
+
+    /**
+    	@brief draw filled rectangle, see ssd1306_fill_rect
+    */
+    void fill_rect(int32_t x, int32_t y, uint32_t width, uint32_t height) {
+        span<Op::set>(x, y, width, height);
+    }
+
+    /**
+    	@brief clear rectangle, see ssd1306_clear_rect
+    */
+    void clear_rect(int32_t x, int32_t y, uint32_t width, uint32_t height) {
+        span<Op::clear>(x, y, width, height);
+    }
+
+    /**
+    	@brief invert rectangle, see ssd1306_invert_rect
+    */
+    void invert_rect(int32_t x, int32_t y, uint32_t width, uint32_t height) {
+        span<Op::invert>(x, y, width, height);
+    }
+
+    /**
+    	@brief clear buffer, see ssd1306_clear
+    */
+    void clear() {
+        ssd1306_clear(&dev);
+    }
+
+    /**
+    	@brief send changes, see ssd1306_show
+    */
+    void show() {
+        ssd1306_show(&dev);
+    }
+
+    /**
+    	@brief send changes in the background, see ssd1306_show_async
+    */
+    bool show_async(ssd1306_flush_cb_t cb=nullptr, void *arg=nullptr) {
+        return ssd1306_show_async(&dev, cb, arg);
+    }
+
+    /**
+    	@brief wait for a background flush
+    */
+    void flush_wait() {
+        ssd1306_flush_wait(&dev);
+    }
+
+private:
+    enum class Op {
+        set,
+        clear,
+        invert,
+    };
+
+    template<Op op> static uint8_t apply(uint8_t b, uint8_t m) {
+        if constexpr(op==Op::set)
+            return b|m;
+        else if constexpr(op==Op::clear)
+            return b&~m;
+        else
+            return b^m;
+    }
+
+    // double buffering finds the spans on swap instead
+    void mark(uint32_t page, uint32_t x0, uint32_t x1) {
+        if(dev.front)
+            return;
+        if(x0<dev.dirty_x0[page])
+            dev.dirty_x0[page]=x0;
+        if(x1>dev.dirty_x1[page])
+            dev.dirty_x1[page]=x1;
+    }
+
+    template<Op op> void update(uint32_t x, uint32_t y) {
+        if(x<dev.clip_x0 || x>=dev.clip_x1 || y<dev.clip_y0 || y>=dev.clip_y1)
+            return;
+
+        uint8_t &b=storage[1+x+Width*(y>>3)];
+        const uint8_t v=apply<op>(b, 1u<<(y&0x07));
+        if(v!=b) {
+            b=v;
+            mark(y>>3, x, x);
+        }
+    }
+
+    // one column run per page, top and bottom page masked
+    template<Op op> void span(int32_t x, int32_t y, uint32_t width, uint32_t height) {
+        const int32_t x0=x>dev.clip_x0?x:dev.clip_x0;
+        const int32_t y0=y>dev.clip_y0?y:dev.clip_y0;
+        const int64_t x1=(int64_t) x+width<dev.clip_x1?(int64_t) x+width:dev.clip_x1;
+        const int64_t y1=(int64_t) y+height<dev.clip_y1?(int64_t) y+height:dev.clip_y1;
+        if(x0>=x1 || y0>=y1)
+            return;
+
+        const uint32_t n=x1-x0, last=(y1-1)>>3;
+        for(uint32_t page=y0>>3; page<=last; ++page) {
+            uint8_t mask=0xff;
+            if(page==(uint32_t) y0>>3)
+                mask&=0xff<<(y0&0x07);
+            if(page==last)
+                mask&=0xff>>(7-((y1-1)&0x07));
+
+            uint8_t *b=storage+1+Width*page+x0;
+            if constexpr(op!=Op::invert) {
+                if(mask==0xff) {
+                    memset(b, op==Op::set?0xff:0x00, n);
+                    mark(page, x0, x0+n-1);
+                    continue;
+                }
+            }
+            for(uint32_t i=0; i<n; ++i)
+                b[i]=apply<op>(b[i], mask);
+            mark(page, x0, x0+n-1);
+        }
+    }
+
+    ssd1306_t dev{};
+    uint8_t storage[SSD1306_BUFFER_SIZE(Width, Height)]{};
+    uint16_t tx[SSD1306_TX_WORDS(Width, Height)]{};
+};
+
+#endif
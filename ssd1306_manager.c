@@ -0,0 +1,170 @@
+/**
+* @file ssd1306_manager.c
+*
+* flush scheduling for several ssd1306 displays on one or two i2c buses
+*/
+
+#include <pico/stdlib.h>
+#include <hardware/i2c.h>
+
+#include "ssd1306.h"
+#include "ssd1306_manager.h"
+
+// bytes on wire besides the display RAM: window commands per flush, address and control per page
+#define SSD1306_MANAGER_FLUSH_OVERHEAD 8
+#define SSD1306_MANAGER_PAGE_OVERHEAD 2
+
+void ssd1306_manager_init(ssd1306_manager_t *m, uint32_t budget_us) {
+    m->count=0;
+    m->rr=0;
+    m->budget_us=budget_us;
+
+    for(uint32_t bus=0; bus<2; ++bus) {
+        m->queue_len[bus]=0;
+        m->queue_pos[bus]=0;
+        m->active[bus]=NULL;
+    }
+}
+
+bool ssd1306_manager_add(ssd1306_manager_t *m, ssd1306_t *p, uint32_t i2c_hz) {
+    // a cost of 0 means clean: the display would never be flushed
+    if(!i2c_hz || m->count==SSD1306_MANAGER_MAX_DISPLAYS)
+        return false;
+
+    m->panels[m->count].p=p;
+    m->panels[m->count].i2c_hz=i2c_hz;
+    m->panels[m->count].skipped=0;
+    m->panels[m->count].failed=0;
+    ++m->count;
+    return true;
+}
+
+uint32_t ssd1306_manager_cost_us(ssd1306_t *p, uint32_t i2c_hz) {
+    uint32_t bytes=0, transactions=0;
+    for(uint32_t page=0; page<p->pages; ++page) {
+        // pages scrolled by the panel are not sent
+        if(p->scrolling && page>=p->scroll_page0 && page<=p->scroll_page1)
+            continue;
+
+        if(p->dirty_x0[page]>p->dirty_x1[page])
+            continue;
+
+        if(p->rotated) {
+            // rotated by 90 or 270: the changed columns are panel pages 8 columns wide
+            const uint32_t panel_pages=(p->dirty_x1[page]>>3)-(p->dirty_x0[page]>>3)+1;
+            bytes+=panel_pages*(8+SSD1306_MANAGER_PAGE_OVERHEAD);
+            transactions+=panel_pages;
+        } else {
+            bytes+=p->dirty_x1[page]-p->dirty_x0[page]+1+SSD1306_MANAGER_PAGE_OVERHEAD;
+            ++transactions;
+        }
+    }
+    if(!bytes || !i2c_hz)
+        return 0;
+
+    bytes+=SSD1306_MANAGER_FLUSH_OVERHEAD;
+    ++transactions;
+
+    // 9 clocks per byte, start and stop per transaction
+    const uint64_t bits=9ull*bytes+2*transactions;
+    return (bits*1000000+i2c_hz-1)/i2c_hz;
+}
+
+// display a goes before b: left out for longer, then more to send
+inline static bool ssd1306_manager_before(const ssd1306_manager_t *m, uint8_t a, uint8_t b, const uint32_t *cost) {
+    if(m->panels[a].skipped!=m->panels[b].skipped)
+        return m->panels[a].skipped>m->panels[b].skipped;
+    return cost[a]>cost[b];
+}
+
+uint32_t ssd1306_manager_flush(ssd1306_manager_t *m) {
+    ssd1306_manager_wait(m);
+
+    uint32_t queued=0;
+    uint32_t cost[SSD1306_MANAGER_MAX_DISPLAYS];
+
+    for(uint32_t bus=0; bus<2; ++bus) {
+        uint8_t order[SSD1306_MANAGER_MAX_DISPLAYS];
+        uint32_t n=0;
+
+        // dirty displays of this bus, starting at the round robin position so ties rotate
+        for(uint32_t k=0; k<m->count; ++k) {
+            const uint8_t i=(m->rr+k)%m->count;
+            ssd1306_manager_panel_t *panel=m->panels+i;
+            if(i2c_get_index(panel->p->i2c_i)!=bus)
+                continue;
+
+            if(!(cost[i]=ssd1306_manager_cost_us(panel->p, panel->i2c_hz))) {
+                panel->skipped=0;
+                continue;
+            }
+
+            // insertion sort, stable
+            uint32_t j=n++;
+            for(; j>0 && ssd1306_manager_before(m, i, order[j-1], cost); --j)
+                order[j]=order[j-1];
+            order[j]=i;
+        }
+
+        // the first display always goes, the others while the budget lasts
+        uint32_t used=0;
+        m->queue_len[bus]=0;
+        m->queue_pos[bus]=0;
+        for(uint32_t j=0; j<n; ++j) {
+            ssd1306_manager_panel_t *panel=m->panels+order[j];
+            if(m->queue_len[bus] && m->budget_us && used+cost[order[j]]>m->budget_us) {
+                ++panel->skipped;
+                continue;
+            }
+
+            used+=cost[order[j]];
+            panel->skipped=0;
+            m->queue[bus][m->queue_len[bus]++]=order[j];
+        }
+        queued+=m->queue_len[bus];
+    }
+
+    if(m->count)
+        m->rr=(m->rr+1)%m->count;
+
+    ssd1306_manager_poll(m);
+    return queued;
+}
+
+bool ssd1306_manager_poll(ssd1306_manager_t *m) {
+    bool pending=false;
+
+    for(uint32_t bus=0; bus<2; ++bus) {
+        if(m->active[bus] && ssd1306_flush_busy(m->active[bus])) {
+            pending=true;
+            continue;
+        }
+        m->active[bus]=NULL;
+
+        if(m->queue_pos[bus]>=m->queue_len[bus])
+            continue;
+
+        ssd1306_manager_panel_t *panel=m->panels+m->queue[bus][m->queue_pos[bus]];
+        pending=true;
+
+        // flushed by someone else right now, try again on the next poll
+        if(ssd1306_flush_busy(panel->p))
+            continue;
+
+        ++m->queue_pos[bus];
+        if(!ssd1306_show_async(panel->p, NULL, NULL)) {
+            // still dirty: first in line next frame
+            ++panel->failed;
+            ++panel->skipped;
+            continue;
+        }
+        m->active[bus]=panel->p;
+    }
+
+    return pending;
+}
+
+void ssd1306_manager_wait(ssd1306_manager_t *m) {
+    while(ssd1306_manager_poll(m))
+        tight_loop_contents();
+}
@@ -0,0 +1,115 @@
+/**
+* @file ssd1306_manager.h
+*
+* flush scheduling for several ssd1306 displays on one or two i2c buses
+*
+* every frame the dirty displays of each bus are put in order (displays left out last
+* frame first, then the ones with most changed bytes) and queued while their estimated
+* transfer time fits the bus budget. both buses transfer at the same time in the
+* background, the queue of a bus advances in ssd1306_manager_poll
+*/
+
+#ifndef _inc_ssd1306_manager
+#define _inc_ssd1306_manager
+#include "ssd1306.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+*	@brief maximum number of displays per manager
+*/
+#ifndef SSD1306_MANAGER_MAX_DISPLAYS
+#define SSD1306_MANAGER_MAX_DISPLAYS 4
+#endif
+
+/**
+*	@brief registered display
+*/
+typedef struct {
+    ssd1306_t *p;			/**< display */
+    uint32_t i2c_hz;		/**< clock of its bus, for the transfer time estimate */
+    uint16_t skipped;		/**< frames it was left out while dirty */
+    uint16_t failed;		/**< flushes ssd1306_show_async refused (no memory for the transfer) */
+} ssd1306_manager_panel_t;
+
+/**
+*	@brief display manager
+*/
+typedef struct {
+    ssd1306_manager_panel_t panels[SSD1306_MANAGER_MAX_DISPLAYS];	/**< registered displays */
+    uint8_t count;			/**< number of registered displays */
+    uint8_t rr;				/**< round robin start among equal displays */
+    uint32_t budget_us;		/**< transfer time per bus and frame, 0: unlimited */
+    uint8_t queue[2][SSD1306_MANAGER_MAX_DISPLAYS];	/**< displays to flush this frame, per bus */
+    uint8_t queue_len[2];	/**< length of queue */
+    uint8_t queue_pos[2];	/**< next display of queue to start */
+    ssd1306_t *active[2];	/**< display transferring on each bus, NULL if idle */
+} ssd1306_manager_t;
+
+/**
+	@brief initialize manager
+
+	@param[in] m : instance of manager
+	@param[in] budget_us : bus time per frame and bus, 0 for no limit. the display with the
+	                       highest priority is flushed even if it alone exceeds the budget
+*/
+void ssd1306_manager_init(ssd1306_manager_t *m, uint32_t budget_us);
+
+/**
+	@brief register an initialized display
+
+	@param[in] m : instance of manager
+	@param[in] p : instance of display
+	@param[in] i2c_hz : clock its bus runs at (return value of i2c_init), not 0
+
+	@return false if i2c_hz is 0 or SSD1306_MANAGER_MAX_DISPLAYS are registered already
+*/
+bool ssd1306_manager_add(ssd1306_manager_t *m, ssd1306_t *p, uint32_t i2c_hz);
+
+/**
+	@brief estimated time needed to send the changed part of a display
+
+	@param[in] p : instance of display
+	@param[in] i2c_hz : bus clock, not 0
+
+	@return microseconds, 0 if nothing changed
+*/
+uint32_t ssd1306_manager_cost_us(ssd1306_t *p, uint32_t i2c_hz);
+
+/**
+	@brief plan a frame and start the first transfer on each bus
+
+	waits for the transfers of the previous frame to finish
+
+	@param[in] m : instance of manager
+
+	@return number of displays queued
+*/
+uint32_t ssd1306_manager_flush(ssd1306_manager_t *m);
+
+/**
+	@brief start the next queued display on every idle bus, call from the main loop
+
+	a display whose flush cannot start stays dirty, counts in failed and skipped and goes
+	first in the next frame
+
+	@param[in] m : instance of manager
+
+	@return true while transfers are queued or running
+*/
+bool ssd1306_manager_poll(ssd1306_manager_t *m);
+
+/**
+	@brief finish all queued transfers
+
+	@param[in] m : instance of manager
+*/
+void ssd1306_manager_wait(ssd1306_manager_t *m);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
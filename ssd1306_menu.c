@@ -0,0 +1,138 @@
+/**
+* @file ssd1306_menu.c
+*
+* scrolling list menu for ssd1306 displays
+*/
+
+#include <pico/stdlib.h>
+
+#include "ssd1306.h"
+#include "ssd1306_menu.h"
+
+// builtin font of ssd1306_draw_string, defined by font.h in ssd1306.c
+extern const uint8_t font_8x5[];
+
+// width of the scroll bar, one more column separates it from the entries
+#define SSD1306_MENU_SCROLLBAR 3
+
+void ssd1306_menu_init(ssd1306_menu_t *m, ssd1306_t *p, const char *title, const ssd1306_menu_item_t *items, uint16_t count, const uint8_t *font) {
+    m->p=p;
+    m->items=items;
+    m->count=count;
+    m->selected=0;
+    m->top=0;
+    m->title=title;
+    m->font=font?font:font_8x5;
+    m->x=0;
+    m->y=0;
+    m->width=p->width;
+    m->height=p->height;
+
+    // whole pages per row
+    m->row_height=(ssd1306_font_height(m->font, 1)+7)&~7u;
+}
+
+inline static uint32_t ssd1306_menu_list_y(const ssd1306_menu_t *m) {
+    return m->y+(m->title?m->row_height:0);
+}
+
+uint32_t ssd1306_menu_rows(const ssd1306_menu_t *m) {
+    const uint32_t title=m->title?m->row_height:0;
+    if(!m->row_height || m->height<=title)
+        return 0;
+    return (m->height-title)/m->row_height;
+}
+
+inline static uint32_t ssd1306_menu_row_width(const ssd1306_menu_t *m) {
+    return m->width-(m->count>ssd1306_menu_rows(m)?SSD1306_MENU_SCROLLBAR+1:0);
+}
+
+// XOR, a second call restores the row
+static void ssd1306_menu_highlight(ssd1306_menu_t *m, uint32_t index) {
+    ssd1306_invert_rect(m->p, m->x, ssd1306_menu_list_y(m)+(index-m->top)*m->row_height, ssd1306_menu_row_width(m), m->row_height);
+}
+
+// text centered vertically in a row, cut at the end of the row
+static void ssd1306_menu_label(ssd1306_menu_t *m, int32_t x, int32_t y, uint32_t width, const char *s) {
+    ssd1306_t *p=m->p;
+    const uint8_t clip_x0=p->clip_x0, clip_y0=p->clip_y0, clip_x1=p->clip_x1, clip_y1=p->clip_y1;
+
+    ssd1306_set_clip(p, x, y, width, m->row_height);
+    ssd1306_draw_string_with_font(p, x, y+(m->row_height-ssd1306_font_height(m->font, 1))/2, 1, m->font, s);
+
+    p->clip_x0=clip_x0;
+    p->clip_y0=clip_y0;
+    p->clip_x1=clip_x1;
+    p->clip_y1=clip_y1;
+}
+
+static void ssd1306_menu_draw_list(ssd1306_menu_t *m) {
+    const uint32_t rows=ssd1306_menu_rows(m), list_y=ssd1306_menu_list_y(m), width=ssd1306_menu_row_width(m);
+
+    ssd1306_clear_rect(m->p, m->x, list_y, m->width, rows*m->row_height);
+    for(uint32_t i=0; i<rows && m->top+i<m->count; ++i)
+        ssd1306_menu_label(m, m->x+2, list_y+i*m->row_height, width-2, m->items[m->top+i].label);
+
+    if(m->count>rows) {
+        // thumb as long as the visible share of the list, at least 3 pixels
+        const uint32_t track=rows*m->row_height;
+        uint32_t thumb=track*rows/m->count;
+        if(thumb<3)
+            thumb=3;
+        const uint32_t thumb_y=(track-thumb)*m->top/(m->count-rows);
+        ssd1306_fill_rect(m->p, m->x+m->width-SSD1306_MENU_SCROLLBAR, list_y+thumb_y, SSD1306_MENU_SCROLLBAR, thumb);
+    }
+
+    if(m->count)
+        ssd1306_menu_highlight(m, m->selected);
+}
+
+void ssd1306_menu_draw(ssd1306_menu_t *m) {
+    ssd1306_clear_rect(m->p, m->x, m->y, m->width, m->height);
+
+    if(m->title) {
+        const uint32_t w=ssd1306_measure_string(m->font, 1, m->title);
+        ssd1306_menu_label(m, m->x+(w<m->width?(m->width-w)/2:0), m->y, m->width, m->title);
+    }
+
+    ssd1306_menu_draw_list(m);
+}
+
+bool ssd1306_menu_select(ssd1306_menu_t *m, uint32_t index) {
+    const uint32_t rows=ssd1306_menu_rows(m);
+    if(!m->count || !rows)
+        return false;
+
+    if(index>=m->count)
+        index=m->count-1;
+    if(index==m->selected)
+        return false;
+
+    // inside the visible rows: only the two bands change
+    if(index>=m->top && index<m->top+rows) {
+        ssd1306_menu_highlight(m, m->selected);
+        m->selected=index;
+        ssd1306_menu_highlight(m, m->selected);
+        return true;
+    }
+
+    m->top=index<m->top?index:index-rows+1;
+    m->selected=index;
+    ssd1306_menu_draw_list(m);
+    return true;
+}
+
+bool ssd1306_menu_move(ssd1306_menu_t *m, int32_t delta) {
+    int32_t index=(int32_t) m->selected+delta;
+    if(index<0)
+        index=0;
+    return ssd1306_menu_select(m, index);
+}
+
+bool ssd1306_menu_activate(ssd1306_menu_t *m) {
+    if(!m->count || !m->items[m->selected].action)
+        return false;
+
+    m->items[m->selected].action();
+    return true;
+}
@@ -0,0 +1,110 @@
+/**
+* @file ssd1306_menu.h
+*
+* scrolling list menu for ssd1306 displays
+*
+* the entries are a table of labels and actions of any length; the visible part is a window
+* of rows that follows the selection. the selected row is inverted (XOR), so moving inside the
+* window only touches the old and new row and the next flush sends just those. rows are a
+* multiple of 8 pixels high, a menu placed at a y multiple of 8 keeps every row in whole pages
+*
+* drawing only changes the buffer, call ssd1306_show afterwards
+*/
+
+#ifndef _inc_ssd1306_menu
+#define _inc_ssd1306_menu
+#include "ssd1306.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+*	@brief menu entry
+*/
+typedef struct {
+    const char *label;		/**< text of the row */
+    void (*action)(void);	/**< run by ssd1306_menu_activate, may be NULL */
+} ssd1306_menu_item_t;
+
+/**
+*	@brief menu state, the layout fields may be changed after ssd1306_menu_init
+*/
+typedef struct {
+    ssd1306_t *p;						/**< display */
+    const ssd1306_menu_item_t *items;	/**< entries */
+    uint16_t count;						/**< number of entries */
+    uint16_t selected;					/**< selected entry */
+    uint16_t top;						/**< first visible entry */
+    const char *title;					/**< title row above the entries, NULL for none */
+    const uint8_t *font;				/**< font of title and entries */
+    uint8_t x;							/**< area of the menu */
+    uint8_t y;
+    uint8_t width;
+    uint8_t height;
+    uint8_t row_height;					/**< height of a row */
+} ssd1306_menu_t;
+
+/**
+	@brief set up a menu covering the whole display
+
+	@param[in] m : instance of menu
+	@param[in] p : instance of display
+	@param[in] title : title row, NULL for none
+	@param[in] items : entries, must stay valid
+	@param[in] count : number of entries
+	@param[in] font : font, NULL for the builtin one
+*/
+void ssd1306_menu_init(ssd1306_menu_t *m, ssd1306_t *p, const char *title, const ssd1306_menu_item_t *items, uint16_t count, const uint8_t *font);
+
+/**
+	@brief number of entries visible at a time
+
+	@param[in] m : instance of menu
+*/
+uint32_t ssd1306_menu_rows(const ssd1306_menu_t *m);
+
+/**
+	@brief draw the whole menu area
+
+	@param[in] m : instance of menu
+*/
+void ssd1306_menu_draw(ssd1306_menu_t *m);
+
+/**
+	@brief select another entry
+
+	inside the visible rows only the two highlight bands are inverted; when the selection
+	leaves them the list scrolls and the entries are redrawn
+
+	@param[in] m : instance of menu
+	@param[in] index : entry to select, clamped to the last one
+
+	@return true if the selection changed
+*/
+bool ssd1306_menu_select(ssd1306_menu_t *m, uint32_t index);
+
+/**
+	@brief move the selection, see ssd1306_menu_select
+
+	@param[in] m : instance of menu
+	@param[in] delta : entries to move down (negative: up), stops at the first and last entry
+
+	@return true if the selection changed
+*/
+bool ssd1306_menu_move(ssd1306_menu_t *m, int32_t delta);
+
+/**
+	@brief run the action of the selected entry
+
+	@param[in] m : instance of menu
+
+	@return false if the entry has no action
+*/
+bool ssd1306_menu_activate(ssd1306_menu_t *m);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
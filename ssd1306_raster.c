@@ -0,0 +1,229 @@
+/** 
+* @file ssd1306_raster.c
+* 
+* integer shape rasterization for ssd1306 displays
+*/
+
+#include <pico/stdlib.h>
+#include <stdlib.h>
+
+#include "ssd1306.h"
+#include "ssd1306_raster.h"
+
+// sin(0..90 degrees) * 1024
+static const uint16_t ssd1306_sin_table[91]= {
+    0, 18, 36, 54, 71, 89, 107, 125, 143, 160, 178, 195, 213, 230, 248, 265,
+    282, 299, 316, 333, 350, 367, 384, 400, 416, 433, 449, 465, 481, 496, 512, 527,
+    543, 558, 573, 587, 602, 616, 630, 644, 658, 672, 685, 698, 711, 724, 737, 749,
+    761, 773, 784, 796, 807, 818, 828, 839, 849, 859, 868, 878, 887, 896, 904, 912,
+    920, 928, 935, 943, 949, 956, 962, 968, 974, 979, 984, 989, 994, 998, 1002, 1005,
+    1008, 1011, 1014, 1016, 1018, 1020, 1022, 1023, 1023, 1024, 1024
+};
+
+static int32_t ssd1306_sin(int32_t deg) {
+    deg%=360;
+    if(deg<0)
+        deg+=360;
+
+    if(deg<=90)
+        return ssd1306_sin_table[deg];
+    if(deg<=180)
+        return ssd1306_sin_table[180-deg];
+    if(deg<=270)
+        return -ssd1306_sin_table[deg-180];
+    return -ssd1306_sin_table[360-deg];
+}
+
+inline static int32_t ssd1306_cos(int32_t deg) {
+    return ssd1306_sin(deg+90);
+}
+
+// rectangle xl..xr, yt..yb grown by a quarter circle of radius r at each corner
+// (a circle when xl==xr and yt==yb), filled with vertical spans or as outline
+static void ssd1306_rounded(ssd1306_t *p, int32_t xl, int32_t yt, int32_t xr, int32_t yb, int32_t r, bool fill) {
+    const int32_t inner=yb-yt+1;
+
+    if(fill) {
+        for(int32_t i=xl; i<=xr; ++i)
+            ssd1306_draw_vline(p, i, yt-r, inner+2*r);
+    } else {
+        ssd1306_draw_hline(p, xl, yt-r, xr-xl+1);
+        ssd1306_draw_hline(p, xl, yb+r, xr-xl+1);
+        ssd1306_draw_vline(p, xl-r, yt, inner);
+        ssd1306_draw_vline(p, xr+r, yt, inner);
+    }
+
+    // midpoint circle, one octant mirrored into the four corners
+    int32_t x=r, y=0, err=1-r;
+    while(y<=x) {
+        if(fill) {
+            ssd1306_draw_vline(p, xr+x, yt-y, inner+2*y);
+            ssd1306_draw_vline(p, xl-x, yt-y, inner+2*y);
+            ssd1306_draw_vline(p, xr+y, yt-x, inner+2*x);
+            ssd1306_draw_vline(p, xl-y, yt-x, inner+2*x);
+        } else {
+            ssd1306_draw_pixel(p, xr+x, yb+y);
+            ssd1306_draw_pixel(p, xr+y, yb+x);
+            ssd1306_draw_pixel(p, xl-x, yb+y);
+            ssd1306_draw_pixel(p, xl-y, yb+x);
+            ssd1306_draw_pixel(p, xr+x, yt-y);
+            ssd1306_draw_pixel(p, xr+y, yt-x);
+            ssd1306_draw_pixel(p, xl-x, yt-y);
+            ssd1306_draw_pixel(p, xl-y, yt-x);
+        }
+
+        ++y;
+        if(err<0) {
+            err+=2*y+1;
+        } else {
+            --x;
+            err+=2*(y-x)+1;
+        }
+    }
+}
+
+static void ssd1306_round_rect(ssd1306_t *p, int32_t x, int32_t y, uint32_t width, uint32_t height, uint32_t r, bool fill) {
+    if(!width || !height)
+        return;
+
+    const uint32_t shorter=width<height?width:height;
+    if(r>(shorter-1)/2)
+        r=(shorter-1)/2;
+
+    ssd1306_rounded(p, x+r, y+r, x+width-1-r, y+height-1-r, r, fill);
+}
+
+void ssd1306_draw_circle(ssd1306_t *p, int32_t xc, int32_t yc, uint32_t r) {
+    ssd1306_rounded(p, xc, yc, xc, yc, r, false);
+}
+
+void ssd1306_fill_circle(ssd1306_t *p, int32_t xc, int32_t yc, uint32_t r) {
+    ssd1306_rounded(p, xc, yc, xc, yc, r, true);
+}
+
+void ssd1306_draw_arc(ssd1306_t *p, int32_t xc, int32_t yc, uint32_t r, int32_t start, int32_t end) {
+    if(end-start>=360) {
+        ssd1306_draw_circle(p, xc, yc, r);
+        return;
+    }
+
+    const int32_t sweep=((end-start)%360+360)%360;
+    const int32_t v0x=ssd1306_cos(start), v0y=ssd1306_sin(start);
+    const int32_t v1x=ssd1306_cos(end), v1y=ssd1306_sin(end);
+
+    // a zero sweep is a single point: the circle point closest to the start ray
+    int32_t best=INT32_MAX, bx=0, by=0;
+
+    int32_t x=r, y=0, err=1-(int32_t)r;
+    while(y<=x) {
+        const int32_t octants[8][2]= {{x, y}, {y, x}, {-y, x}, {-x, y}, {-x, -y}, {-y, -x}, {y, -x}, {x, -y}};
+
+        for(uint32_t i=0; i<8; ++i) {
+            const int32_t dx=octants[i][0], dy=octants[i][1];
+            // cross products: >=0 when the point lies clockwise of start / counter-clockwise of end
+            const int32_t c0=v0x*dy-v0y*dx, c1=dx*v1y-dy*v1x;
+
+            if(!sweep) {
+                if(v0x*dx+v0y*dy>0 && abs(c0)<best) {
+                    best=abs(c0);
+                    bx=dx;
+                    by=dy;
+                }
+                continue;
+            }
+
+            if(sweep<=180?(c0>=0 && c1>=0):(c0>=0 || c1>=0))
+                ssd1306_draw_pixel(p, xc+dx, yc+dy);
+        }
+
+        ++y;
+        if(err<0) {
+            err+=2*y+1;
+        } else {
+            --x;
+            err+=2*(y-x)+1;
+        }
+    }
+
+    if(!sweep)
+        ssd1306_draw_pixel(p, xc+bx, yc+by);
+}
+
+void ssd1306_draw_round_rect(ssd1306_t *p, int32_t x, int32_t y, uint32_t width, uint32_t height, uint32_t r) {
+    ssd1306_round_rect(p, x, y, width, height, r, false);
+}
+
+void ssd1306_fill_round_rect(ssd1306_t *p, int32_t x, int32_t y, uint32_t width, uint32_t height, uint32_t r) {
+    ssd1306_round_rect(p, x, y, width, height, r, true);
+}
+
+void ssd1306_draw_triangle(ssd1306_t *p, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2) {
+    ssd1306_draw_line(p, x0, y0, x1, y1);
+    ssd1306_draw_line(p, x1, y1, x2, y2);
+    ssd1306_draw_line(p, x2, y2, x0, y0);
+}
+
+void ssd1306_fill_triangle(ssd1306_t *p, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2) {
+    const ssd1306_point_t points[3]= {{x0, y0}, {x1, y1}, {x2, y2}};
+    ssd1306_fill_polygon(p, points, 3);
+}
+
+void ssd1306_draw_polygon(ssd1306_t *p, const ssd1306_point_t *points, size_t n) {
+    if(!n)
+        return;
+
+    for(size_t i=0, j=n-1; i<n; j=i++)
+        ssd1306_draw_line(p, points[j].x, points[j].y, points[i].x, points[i].y);
+}
+
+void ssd1306_fill_polygon(ssd1306_t *p, const ssd1306_point_t *points, size_t n) {
+    if(n<3) {
+        ssd1306_draw_polygon(p, points, n);
+        return;
+    }
+
+    int32_t xmin=points[0].x, xmax=points[0].x;
+    for(size_t i=1; i<n; ++i) {
+        if(points[i].x<xmin)
+            xmin=points[i].x;
+        if(points[i].x>xmax)
+            xmax=points[i].x;
+    }
+    if(xmin<0)
+        xmin=0;
+    if(xmax>=p->width)
+        xmax=p->width-1;
+
+    // scan columns instead of rows: every span is a vertical run of page bytes
+    int32_t ys[SSD1306_POLYGON_MAX_CROSSINGS];
+    for(int32_t x=xmin; x<=xmax; ++x) {
+        size_t count=0;
+
+        for(size_t i=0, j=n-1; i<n; j=i++) {
+            int32_t x0=points[j].x, y0=points[j].y, x1=points[i].x, y1=points[i].y;
+            if(x0==x1)
+                continue;
+            if(x0>x1) {
+                x0=points[i].x;
+                y0=points[i].y;
+                x1=points[j].x;
+                y1=points[j].y;
+            }
+            // half open so shared vertices are counted once
+            if(x<x0 || x>=x1 || count==SSD1306_POLYGON_MAX_CROSSINGS)
+                continue;
+
+            const int32_t y=y0+(x-x0)*(y1-y0)/(x1-x0);
+            size_t k=count++;
+            for(; k>0 && ys[k-1]>y; --k)
+                ys[k]=ys[k-1];
+            ys[k]=y;
+        }
+
+        for(size_t k=0; k+1<count; k+=2)
+            ssd1306_draw_vline(p, x, ys[k], ys[k+1]-ys[k]+1);
+    }
+
+    // edges on the closing column and vertical edges are not crossed by the scan
+    ssd1306_draw_polygon(p, points, n);
+}
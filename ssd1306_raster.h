@@ -0,0 +1,138 @@
+/** 
+* @file ssd1306_raster.h
+* 
+* integer shape rasterization for ssd1306 displays
+*
+* coordinates are signed and clipped to the display, filled shapes are written as
+* vertical spans so every covered page byte is touched once per column
+*/
+
+#ifndef _inc_ssd1306_raster
+#define _inc_ssd1306_raster
+#include "ssd1306.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+*	@brief maximum number of edge crossings per column handled by ssd1306_fill_polygon
+*/
+#define SSD1306_POLYGON_MAX_CROSSINGS 32
+
+/**
+*	@brief polygon vertex
+*/
+typedef struct {
+    int16_t x;	/**< x position */
+    int16_t y;	/**< y position */
+} ssd1306_point_t;
+
+/**
+	@brief draw circle outline on buffer
+
+	@param[in] p : instance of display
+	@param[in] xc : x position of center
+	@param[in] yc : y position of center
+	@param[in] r : radius
+*/
+void ssd1306_draw_circle(ssd1306_t *p, int32_t xc, int32_t yc, uint32_t r);
+
+/**
+	@brief draw filled circle on buffer
+
+	@param[in] p : instance of display
+	@param[in] xc : x position of center
+	@param[in] yc : y position of center
+	@param[in] r : radius
+*/
+void ssd1306_fill_circle(ssd1306_t *p, int32_t xc, int32_t yc, uint32_t r);
+
+/**
+	@brief draw circular arc on buffer
+
+	angles are in degrees, 0 points right and angles grow clockwise (towards +y)
+
+	@param[in] p : instance of display
+	@param[in] xc : x position of center
+	@param[in] yc : y position of center
+	@param[in] r : radius
+	@param[in] start : angle of first point
+	@param[in] end : angle of last point, end-start>=360 draws the full circle, an end equal
+	to start (or a multiple of 360 below it) a single point at the start angle
+*/
+void ssd1306_draw_arc(ssd1306_t *p, int32_t xc, int32_t yc, uint32_t r, int32_t start, int32_t end);
+
+/**
+	@brief draw rectangle outline with rounded corners on buffer
+
+	@param[in] p : instance of display
+	@param[in] x : x position of starting point
+	@param[in] y : y position of starting point
+	@param[in] width : width of rectangle
+	@param[in] height : height of rectangle
+	@param[in] r : corner radius (limited to half of the shorter side)
+*/
+void ssd1306_draw_round_rect(ssd1306_t *p, int32_t x, int32_t y, uint32_t width, uint32_t height, uint32_t r);
+
+/**
+	@brief draw filled rectangle with rounded corners on buffer
+
+	@param[in] p : instance of display
+	@param[in] x : x position of starting point
+	@param[in] y : y position of starting point
+	@param[in] width : width of rectangle
+	@param[in] height : height of rectangle
+	@param[in] r : corner radius (limited to half of the shorter side)
+*/
+void ssd1306_fill_round_rect(ssd1306_t *p, int32_t x, int32_t y, uint32_t width, uint32_t height, uint32_t r);
+
+/**
+	@brief draw triangle outline on buffer
+
+	@param[in] p : instance of display
+	@param[in] x0 : x position of first corner
+	@param[in] y0 : y position of first corner
+	@param[in] x1 : x position of second corner
+	@param[in] y1 : y position of second corner
+	@param[in] x2 : x position of third corner
+	@param[in] y2 : y position of third corner
+*/
+void ssd1306_draw_triangle(ssd1306_t *p, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2);
+
+/**
+	@brief draw filled triangle on buffer
+
+	@param[in] p : instance of display
+	@param[in] x0 : x position of first corner
+	@param[in] y0 : y position of first corner
+	@param[in] x1 : x position of second corner
+	@param[in] y1 : y position of second corner
+	@param[in] x2 : x position of third corner
+	@param[in] y2 : y position of third corner
+*/
+void ssd1306_fill_triangle(ssd1306_t *p, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2);
+
+/**
+	@brief draw closed polygon outline on buffer
+
+	@param[in] p : instance of display
+	@param[in] points : vertices
+	@param[in] n : number of vertices
+*/
+void ssd1306_draw_polygon(ssd1306_t *p, const ssd1306_point_t *points, size_t n);
+
+/**
+	@brief draw filled polygon on buffer (even-odd rule)
+
+	@param[in] p : instance of display
+	@param[in] points : vertices
+	@param[in] n : number of vertices
+*/
+void ssd1306_fill_polygon(ssd1306_t *p, const ssd1306_point_t *points, size_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
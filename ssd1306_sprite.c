@@ -0,0 +1,96 @@
+/**
+* @file ssd1306_sprite.c
+*
+* sprites and bit block transfers for ssd1306 displays
+*/
+
+#include <pico/stdlib.h>
+#include <string.h>
+
+#include "ssd1306.h"
+#include "ssd1306_sprite.h"
+
+// source byte for column i of a display page: a 16 bit column word shifted down to the page
+#define SSD1306_BLT_SRC(lo, hi, i, sh) ((uint8_t) ((((hi)?(uint32_t) (hi)[i]<<8:0)|((lo)?(lo)[i]:0))>>(sh)))
+
+void ssd1306_bitblt(ssd1306_t *p, int32_t x, int32_t y, const uint8_t *bitmap, const uint8_t *mask, uint32_t width, uint32_t height, ssd1306_rop_t rop) {
+    if(rop==SSD1306_ROP_MASKED && !mask)
+        rop=SSD1306_ROP_COPY;
+
+    int32_t cx=x<p->clip_x0?p->clip_x0:x, cy=y<p->clip_y0?p->clip_y0:y;
+    int32_t cx1=x+(int32_t) width, cy1=y+(int32_t) height;
+    if(cx1>p->clip_x1)
+        cx1=p->clip_x1;
+    if(cy1>p->clip_y1)
+        cy1=p->clip_y1;
+    if(cx>=cx1 || cy>=cy1)
+        return;
+
+    const int32_t cw=cx1-cx;
+    const int32_t src_pages=(height+7)>>3;
+
+    for(int32_t page=cy>>3; page<=(cy1-1)>>3; ++page) {
+        uint8_t m=0xff;
+        if(page==cy>>3)
+            m&=0xff<<(cy&0x07);
+        if(page==(cy1-1)>>3)
+            m&=0xff>>(7-((cy1-1)&0x07));
+
+        // display rows of this page start at bitmap row r, i.e. bit sh of bitmap page sk
+        const int32_t r=(page<<3)-y;
+        const int32_t sk=r>>3; // rounds down for negative r
+        const uint32_t sh=r&0x07;
+        const size_t lo_off=sk*width+(cx-x), hi_off=(sk+1)*width+(cx-x);
+        const bool has_lo=sk>=0 && sk<src_pages, has_hi=sh && sk+1>=0 && sk+1<src_pages;
+
+        const uint8_t *lo=has_lo?bitmap+lo_off:NULL, *hi=has_hi?bitmap+hi_off:NULL;
+        uint8_t *d=p->buffer+page*p->width+cx;
+
+        switch(rop) {
+        case SSD1306_ROP_COPY:
+            if(m==0xff && !sh) {
+                memcpy(d, lo, cw);
+                break;
+            }
+            for(int32_t i=0; i<cw; ++i)
+                d[i]=(d[i]&~m)|(SSD1306_BLT_SRC(lo, hi, i, sh)&m);
+            break;
+        case SSD1306_ROP_OR:
+            for(int32_t i=0; i<cw; ++i)
+                d[i]|=SSD1306_BLT_SRC(lo, hi, i, sh)&m;
+            break;
+        case SSD1306_ROP_AND_NOT:
+            for(int32_t i=0; i<cw; ++i)
+                d[i]&=~(SSD1306_BLT_SRC(lo, hi, i, sh)&m);
+            break;
+        case SSD1306_ROP_XOR:
+            for(int32_t i=0; i<cw; ++i)
+                d[i]^=SSD1306_BLT_SRC(lo, hi, i, sh)&m;
+            break;
+        case SSD1306_ROP_MASKED: {
+            const uint8_t *mlo=has_lo?mask+lo_off:NULL, *mhi=has_hi?mask+hi_off:NULL;
+            for(int32_t i=0; i<cw; ++i) {
+                const uint8_t mm=SSD1306_BLT_SRC(mlo, mhi, i, sh)&m;
+                d[i]=(d[i]&~mm)|(SSD1306_BLT_SRC(lo, hi, i, sh)&mm);
+            }
+            break;
+        }
+        }
+    }
+
+    ssd1306_mark_dirty(p, cx, cy, cw, cy1-cy);
+}
+
+void ssd1306_blit_page_image(ssd1306_t *p, int32_t x, int32_t y, const uint8_t *image, uint32_t width, uint32_t height) {
+    ssd1306_bitblt(p, x, y, image, NULL, width, height, SSD1306_ROP_COPY);
+}
+
+void ssd1306_sprite_draw(ssd1306_t *p, const ssd1306_sprite_t *sprite, uint32_t frame, int32_t x, int32_t y, ssd1306_rop_t rop) {
+    const size_t frame_size=sprite->width*((sprite->height+7)>>3);
+    if(sprite->frames>1)
+        frame%=sprite->frames;
+    else
+        frame=0;
+
+    ssd1306_bitblt(p, x, y, sprite->bitmap+frame*frame_size, sprite->mask?sprite->mask+frame*frame_size:NULL, sprite->width, sprite->height, rop);
+}
@@ -0,0 +1,88 @@
+/**
+* @file ssd1306_sprite.h
+*
+* sprites and bit block transfers for ssd1306 displays
+*
+* bitmaps are in display layout (width bytes per page of 8 rows, least significant bit
+* on top, see tools/ssd1306_imgc.py) and can be placed at any x/y; they are combined
+* with the buffer a page row at a time from shifted 16 bit column words
+*/
+
+#ifndef _inc_ssd1306_sprite
+#define _inc_ssd1306_sprite
+#include "ssd1306.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+*	@brief how source pixels are combined with the buffer
+*/
+typedef enum {
+    SSD1306_ROP_COPY,		/**< buffer=source, the whole rectangle is replaced */
+    SSD1306_ROP_OR,			/**< buffer|=source, set pixels are drawn */
+    SSD1306_ROP_AND_NOT,	/**< buffer&=~source, set pixels are erased */
+    SSD1306_ROP_XOR,		/**< buffer^=source, set pixels are inverted */
+    SSD1306_ROP_MASKED,		/**< buffer=source where the mask is set, like COPY without a mask */
+} ssd1306_rop_t;
+
+/**
+*	@brief sprite, optionally with a mask and several animation frames
+*/
+typedef struct {
+    uint8_t width;			/**< width of one frame */
+    uint8_t height;			/**< height of one frame */
+    uint8_t frames;			/**< number of frames, stored one after the other */
+    const uint8_t *bitmap;	/**< width*((height+7)/8) bytes per frame */
+    const uint8_t *mask;	/**< same layout as bitmap, NULL if opaque */
+} ssd1306_sprite_t;
+
+/**
+	@brief combine a bitmap with the buffer
+
+	the bitmap is clipped to the clip area and the touched region is marked dirty
+
+	@param[in] p : instance of display
+	@param[in] x : x position of the left column, may be negative
+	@param[in] y : y position of the top row, may be negative
+	@param[in] bitmap : bitmap in display layout
+	@param[in] mask : mask in display layout for SSD1306_ROP_MASKED, NULL otherwise
+	@param[in] width : width of bitmap
+	@param[in] height : height of bitmap
+	@param[in] rop : raster operation
+*/
+void ssd1306_bitblt(ssd1306_t *p, int32_t x, int32_t y, const uint8_t *bitmap, const uint8_t *mask, uint32_t width, uint32_t height, ssd1306_rop_t rop);
+
+/**
+	@brief copy an image in display layout (see tools/ssd1306_imgc.py) into the buffer
+
+	@param[in] p : instance of display
+	@param[in] x : x position of the left column
+	@param[in] y : y position of the top row
+	@param[in] image : width bytes per page, least significant bit on top
+	@param[in] width : width of image
+	@param[in] height : height of image
+
+	pixels of the rectangle are replaced, including the ones cleared in the image; the same as
+	ssd1306_bitblt with SSD1306_ROP_COPY and no mask
+*/
+void ssd1306_blit_page_image(ssd1306_t *p, int32_t x, int32_t y, const uint8_t *image, uint32_t width, uint32_t height);
+
+/**
+	@brief draw one frame of a sprite
+
+	@param[in] p : instance of display
+	@param[in] sprite : sprite to draw
+	@param[in] frame : frame number, wraps around at sprite->frames
+	@param[in] x : x position of the left column, may be negative
+	@param[in] y : y position of the top row, may be negative
+	@param[in] rop : raster operation, SSD1306_ROP_MASKED uses sprite->mask
+*/
+void ssd1306_sprite_draw(ssd1306_t *p, const ssd1306_sprite_t *sprite, uint32_t frame, int32_t x, int32_t y, ssd1306_rop_t rop);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -4,6 +4,7 @@
 #include "ssd1306.h"
 #include "hardware/i2c.h"
 #include "hardware/pwm.h"
+#include "input.h"
 
 // Pinos
 const uint I2C_SDA = 14;
@@ -13,6 +14,9 @@ const uint BUTTON_PIN_B = 6;
 const uint LED_VERDE = 11;
 const uint LED_VERMELHO = 13;
 
+// Botões tratados por interrupção
+static input_pin_t botao_a, botao_b;
+
 // Área de renderização
 struct render_area frame_area = {
     start_column : 0,
@@ -88,12 +92,17 @@ void SinalFechado(void) {
     mensagemDisplay(text, 3);
 };
 
+// Espera até seg segundos por um pressionamento de A ou B, dormindo até o evento
 int WaitWithRead(int seg) {
-    for (int i = 0; i < seg * 10; i++) {
-        if (gpio_get(BUTTON_PIN_A) == 0 || gpio_get(BUTTON_PIN_B) == 0) {
+    // Só contam os pressionamentos durante a espera
+    input_flush();
+
+    uint64_t until = time_us_64() + seg * 1000000ull;
+    input_event_t e;
+    while (input_wait(&e, until)) {
+        if (e.type == INPUT_PRESS) {
             return 1;
         }
-        sleep_ms(100);
     }
     return 0;
 };
@@ -101,14 +110,12 @@ int WaitWithRead(int seg) {
 int main() {
     stdio_init_all();
 
-    // Configuração dos botões
-    gpio_init(BUTTON_PIN_A);
-    gpio_set_dir(BUTTON_PIN_A, GPIO_IN);
-    gpio_pull_up(BUTTON_PIN_A);
-
-    gpio_init(BUTTON_PIN_B);
-    gpio_set_dir(BUTTON_PIN_B, GPIO_IN);
-    gpio_pull_up(BUTTON_PIN_B);
+    // Configuração dos botões, com pull-up e interrupção
+    input_init(NULL, 0);
+    input_pin_init(&botao_a, BUTTON_PIN_A, true);
+    input_add(&botao_a);
+    input_pin_init(&botao_b, BUTTON_PIN_B, true);
+    input_add(&botao_b);
 
     // Configuração dos LEDs
     gpio_init(LED_VERDE);
@@ -0,0 +1,217 @@
+/**
+* @file tone.c
+*
+* background tone sequencer on a PWM pin
+*/
+
+#include <pico/stdlib.h>
+#include <hardware/clocks.h>
+#include <hardware/pwm.h>
+#include <hardware/sync.h>
+
+#include "tone.h"
+
+static const uint32_t tone_ratio[12]=PWM_FREQ_SEMITONE_Q16;
+
+uint32_t tone_midi_mhz(uint8_t midi) {
+    const int32_t n=(int32_t) midi-69+12*11;	// positive for all MIDI numbers
+    const int32_t octave=n/12-11;
+    const uint64_t f=440000ull*tone_ratio[n%12];
+    const uint64_t g=octave>=0?f<<octave:f>>-octave;
+    return (uint32_t) ((g+(1u<<15))>>16);
+}
+
+void tone_output(tone_player_t *p, uint32_t freq_mhz) {
+    if(!freq_mhz)
+        pwm_set_gpio_level(p->pin, 0);
+    else
+        pwm_freq_apply(p->pin, pwm_freq_solve(clock_get_hz(clk_sys), freq_mhz));
+}
+
+// notes solved at run time when clk_sys is not TONE_CLK_HZ
+static pwm_freq_t tone_solved[TONE_CMD_TEMPO];
+static uint32_t tone_solved_mask[(TONE_CMD_TEMPO+31)/32];
+
+// solve the notes of a song that are not solved yet
+static void tone_solve_song(const tone_song_t *song) {
+    const uint32_t clk_hz=clock_get_hz(clk_sys);
+    for(uint32_t i=0; i<song->length; ++i) {
+        const uint32_t pitch=song->words[i]>>9;
+        if(!pitch || pitch>=TONE_CMD_TEMPO || tone_solved_mask[pitch/32]&(1u<<pitch%32))
+            continue;
+        tone_solved[pitch]=pwm_freq_solve(clk_hz, tone_midi_mhz(pitch));
+        tone_solved_mask[pitch/32]|=1u<<pitch%32;
+    }
+}
+
+inline static void tone_note(tone_player_t *p, uint32_t pitch) {
+    pwm_freq_apply(p->pin, p->notes[pitch]);
+}
+
+void tone_init(tone_player_t *p, uint8_t pin) {
+    *p=(tone_player_t) {
+        .pin=pin,
+        .state=TONE_STOPPED,
+        .notes=clock_get_hz(clk_sys)==TONE_CLK_HZ?tone_midi_table:tone_solved,
+    };
+
+    gpio_set_function(pin, GPIO_FUNC_PWM);
+    const uint slice=pwm_gpio_to_slice_num(pin);
+    pwm_config config=pwm_get_default_config();
+    pwm_init(slice, &config, true);
+    pwm_set_gpio_level(pin, 0);
+}
+
+// end of the song: silent, stopped, then the callback (which may start another song)
+static void tone_finish(tone_player_t *p) {
+    tone_output(p, 0);
+    p->sounding=false;
+    p->alarm=0;
+    p->state=TONE_STOPPED;
+    if(p->done)
+        p->done(p, p->done_arg);
+}
+
+// run the song up to the next note or rest and start it, 0 at the end
+static uint32_t tone_step(tone_player_t *p) {
+    if(p->sounding && p->gap_left_us) {
+        const uint32_t d=p->gap_left_us;
+        tone_output(p, 0);
+        p->sounding=false;
+        p->gap_left_us=0;
+        return d;
+    }
+
+    const tone_song_t *s=p->song;
+    // a loop without notes would spin forever in the interrupt
+    for(uint32_t budget=s->length; budget && p->pos<s->length; --budget) {
+        const uint16_t w=s->words[p->pos++];
+        const uint32_t pitch=w>>9, arg=w&TONE_ARG_MAX;
+
+        switch(pitch) {
+        case TONE_CMD_TEMPO:
+            p->tick_us=(arg?arg:1)*1000;
+            continue;
+        case TONE_CMD_GAP:
+            p->gap_us=arg*1000;
+            continue;
+        case TONE_CMD_LOOP:
+            p->loop_pos=p->pos;
+            p->loop_left=UINT16_MAX;
+            continue;
+        case TONE_CMD_REPEAT:
+            if(!arg) {
+                p->pos=p->loop_pos;
+                continue;
+            }
+            if(p->loop_left==UINT16_MAX)
+                p->loop_left=arg;
+            if(p->loop_left) {
+                --p->loop_left;
+                p->pos=p->loop_pos;
+            } else {
+                p->loop_left=UINT16_MAX;
+            }
+            continue;
+        default:
+            break;
+        }
+
+        if(pitch>=TONE_CMD_TEMPO || !arg)
+            continue;
+
+        const uint32_t len=arg*p->tick_us;
+        if(!pitch) {
+            tone_output(p, 0);
+            p->sounding=false;
+            return len;
+        }
+
+        tone_note(p, pitch);
+        p->sounding=true;
+        p->gap_left_us=p->gap_us<len?p->gap_us:0;
+        return len-p->gap_left_us;
+    }
+    return 0;
+}
+
+// the negative return reschedules from the previous target, so the steps do not drift
+static int64_t tone_alarm(alarm_id_t id, void *user_data) {
+    (void) id;
+    tone_player_t *p=user_data;
+    if(p->state!=TONE_PLAYING)
+        return 0;
+
+    const uint32_t d=tone_step(p);
+    if(!d) {
+        // clears p->alarm, unless the done callback starts another song with its own alarm
+        tone_finish(p);
+        return 0;
+    }
+    p->due+=d;
+    return -(int64_t) d;
+}
+
+// start the alarm at p->due: a time already past fires from the alarm interrupt at once, so
+// the id is stored with interrupts off, before a step (or the end of the song) can run
+static void tone_arm(tone_player_t *p) {
+    const uint32_t irq=save_and_disable_interrupts();
+    p->alarm=add_alarm_at(from_us_since_boot(p->due), tone_alarm, p, true);
+    restore_interrupts(irq);
+}
+
+// cancel the alarm without a step running in between
+static void tone_halt(tone_player_t *p, tone_state_t state) {
+    const uint32_t irq=save_and_disable_interrupts();
+    if(p->alarm)
+        cancel_alarm(p->alarm);
+    p->alarm=0;
+    p->state=state;
+    restore_interrupts(irq);
+}
+
+void tone_stop(tone_player_t *p) {
+    tone_halt(p, TONE_STOPPED);
+    p->sounding=false;
+    tone_output(p, 0);
+}
+
+void tone_play(tone_player_t *p, const tone_song_t *song, tone_done_cb_t done, void *arg) {
+    tone_stop(p);
+    if(p->notes==tone_solved)
+        tone_solve_song(song);
+    p->song=song;
+    p->pos=p->loop_pos=0;
+    p->loop_left=UINT16_MAX;
+    p->tick_us=10000;
+    p->gap_us=p->gap_left_us=0;
+    p->done=done;
+    p->done_arg=arg;
+    p->due=time_us_64();
+    p->state=TONE_PLAYING;
+
+    // the first step is due now, the alarm interrupt runs it and all the others
+    tone_arm(p);
+}
+
+void tone_pause(tone_player_t *p) {
+    if(p->state!=TONE_PLAYING)
+        return;
+
+    tone_halt(p, TONE_PAUSED);
+    const uint64_t now=time_us_64();
+    p->paused_left=p->due>now?p->due-now:0;
+    pwm_set_gpio_level(p->pin, 0);
+}
+
+void tone_resume(tone_player_t *p) {
+    if(p->state!=TONE_PAUSED)
+        return;
+
+    // a sounding note is the word before pos
+    if(p->sounding)
+        tone_note(p, p->song->words[p->pos-1]>>9);
+    p->due=time_us_64()+p->paused_left;
+    p->state=TONE_PLAYING;
+    tone_arm(p);
+}
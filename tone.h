@@ -0,0 +1,212 @@
+/**
+* @file tone.h
+*
+* background tone sequencer on a PWM pin
+*
+* a song is an array of 16-bit words: a pitch (MIDI note number, 0 for a rest) in the top 7
+* bits and a length in ticks in the low 9 bits; pitches from TONE_CMD_TEMPO up are commands
+* (tick length, gap between notes, loop start and repeat). a hardware alarm steps through the
+* song: its callback switches the PWM to the next note and reschedules itself relative to the
+* previous target, so timing does not drift and play, pause and stop return at once. the end
+* of a song is reported by a callback from the alarm interrupt
+*
+* notes come from a table of PWM register values (see pwm_freq.h) computed at compile time for
+* TONE_CLK_HZ, so the interrupt switches a note with two register writes. at another clk_sys
+* tone_play solves the notes of the song first
+*
+*   TONE_SONG(intro,
+*       TONE_TEMPO(50), TONE_GAP(20),
+*       TONE_LOOP(),
+*       TONE_NOTE(69, 10), TONE_REST(4), TONE_NOTE(72, 6),
+*       TONE_REPEAT(2));
+*   tone_play(&player, &intro, NULL, NULL);
+*/
+
+#ifndef _inc_tone
+#define _inc_tone
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <pico/time.h>
+
+#include "pwm_freq.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+*	@brief clk_sys of tone_midi_table
+*/
+#ifndef TONE_CLK_HZ
+#define TONE_CLK_HZ 125000000
+#endif
+
+/**
+*	@brief register values of the MIDI notes below TONE_CMD_TEMPO at TONE_CLK_HZ, in flash (tone_table.cpp)
+*/
+extern const pwm_freq_t *const tone_midi_table;
+
+/**
+*	@brief first pitch value used as a command
+*/
+#define TONE_CMD_TEMPO 120
+#define TONE_CMD_GAP 121
+#define TONE_CMD_LOOP 122
+#define TONE_CMD_REPEAT 123
+
+/**
+*	@brief largest length or command argument
+*/
+#define TONE_ARG_MAX 511
+
+#define TONE_WORD(pitch, arg) ((uint16_t) (((pitch)<<9)|((arg)&TONE_ARG_MAX)))
+
+/**
+*	@brief note of a MIDI number (69 is A4, 440 Hz) for a number of ticks
+*/
+#define TONE_NOTE(midi, ticks) TONE_WORD(midi, ticks)
+
+/**
+*	@brief silence for a number of ticks
+*/
+#define TONE_REST(ticks) TONE_WORD(0, ticks)
+
+/**
+*	@brief length of a tick in milliseconds, 1-511, default 10
+*/
+#define TONE_TEMPO(ms) TONE_WORD(TONE_CMD_TEMPO, ms)
+
+/**
+*	@brief silence at the end of every note in milliseconds, taken from its length, default 0
+*/
+#define TONE_GAP(ms) TONE_WORD(TONE_CMD_GAP, ms)
+
+/**
+*	@brief start of the part repeated by TONE_REPEAT, the song start if none
+*/
+#define TONE_LOOP() TONE_WORD(TONE_CMD_LOOP, 0)
+
+/**
+*	@brief play the part since TONE_LOOP n more times, 0 forever
+*/
+#define TONE_REPEAT(n) TONE_WORD(TONE_CMD_REPEAT, n)
+
+/**
+*	@brief song, see TONE_SONG
+*/
+typedef struct {
+    const uint16_t *words;	/**< packed notes and commands */
+    uint16_t length;		/**< number of words */
+} tone_song_t;
+
+/**
+*	@brief define a song from packed words, empty songs and songs over 65535 words do not compile
+*
+*	@param[in] name : name of the tone_song_t
+*/
+#define TONE_SONG(name, ...) \
+    static const uint16_t name##_words[]= {__VA_ARGS__}; \
+    _Static_assert(sizeof(name##_words)/sizeof(name##_words[0])>0 && \
+                   sizeof(name##_words)/sizeof(name##_words[0])<=UINT16_MAX, #name ": song length out of range"); \
+    static const tone_song_t name= {name##_words, sizeof(name##_words)/sizeof(name##_words[0])}
+
+/**
+*	@brief player state
+*/
+typedef enum {
+    TONE_STOPPED,
+    TONE_PLAYING,
+    TONE_PAUSED,
+} tone_state_t;
+
+struct tone_player;
+
+/**
+*	@brief called from the alarm interrupt when a song ends by itself
+*/
+typedef void (*tone_done_cb_t)(struct tone_player *p, void *arg);
+
+/**
+*	@brief player of one PWM pin, owned by the caller (usually static)
+*/
+typedef struct tone_player {
+    uint8_t pin;					/**< PWM pin */
+    volatile uint8_t state;			/**< tone_state_t */
+    bool sounding;					/**< a note is on */
+    uint16_t pos;					/**< next word */
+    uint16_t loop_pos;				/**< word after TONE_LOOP */
+    uint16_t loop_left;				/**< repeats left, UINT16_MAX if not counting */
+    uint32_t tick_us;				/**< tick length */
+    uint32_t gap_us;				/**< silence at the end of a note */
+    uint32_t gap_left_us;			/**< gap still due after the sounding part */
+    uint64_t due;					/**< time of the next step */
+    uint64_t paused_left;			/**< time left of the step when paused */
+    alarm_id_t alarm;				/**< running alarm, 0 if none */
+    const tone_song_t *song;		/**< song */
+    const pwm_freq_t *notes;		/**< register values of the MIDI notes */
+    tone_done_cb_t done;			/**< end callback */
+    void *done_arg;					/**< argument of done */
+} tone_player_t;
+
+/**
+	@brief set up the pin for PWM, silent
+
+	@param[in] p : player
+	@param[in] pin : GPIO with a PWM output
+*/
+void tone_init(tone_player_t *p, uint8_t pin);
+
+/**
+	@brief start a song from the beginning, stops the current one
+
+	@param[in] p : player
+	@param[in] song : song, must stay valid while playing
+	@param[in] done : called from the interrupt when the song ends, not on tone_stop; may be NULL
+	@param[in] arg : argument of done
+*/
+void tone_play(tone_player_t *p, const tone_song_t *song, tone_done_cb_t done, void *arg);
+
+/**
+	@brief stop and silence
+
+	@param[in] p : player
+*/
+void tone_stop(tone_player_t *p);
+
+/**
+	@brief pause, tone_resume continues the note where it was
+
+	@param[in] p : player
+*/
+void tone_pause(tone_player_t *p);
+
+/**
+	@brief continue after tone_pause
+
+	@param[in] p : player
+*/
+void tone_resume(tone_player_t *p);
+
+/**
+	@brief sound a frequency until changed, for direct use while no song plays
+
+	solves the divider at every call (milliseconds), keep pwm_freq_t values for fast changes
+
+	@param[in] p : player
+	@param[in] freq_mhz : frequency in millihertz, 0 for silence
+*/
+void tone_output(tone_player_t *p, uint32_t freq_mhz);
+
+/**
+	@brief frequency of a MIDI note in millihertz, equal temperament with A4 (69) at 440 Hz
+
+	@param[in] midi : note number
+*/
+uint32_t tone_midi_mhz(uint8_t midi);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
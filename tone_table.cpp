@@ -0,0 +1,25 @@
+/**
+* @file tone_table.cpp
+*
+* PWM register values of the MIDI notes at TONE_CLK_HZ, solved at compile time
+*/
+
+#include "pwm_freq.hpp"
+#include "tone.h"
+
+// pitches from TONE_CMD_TEMPO up are commands
+static constexpr auto &tone_midi_table_cx=pwm_freq_midi_table<TONE_CLK_HZ, 0, TONE_CMD_TEMPO>;
+
+constexpr uint32_t tone_worst_ppm() {
+    uint32_t worst=0;
+    for(uint8_t m=1; m<TONE_CMD_TEMPO; ++m) {
+        const uint32_t e=pwm_freq_error_ppm(TONE_CLK_HZ, pwm_freq_midi_mhz(m), tone_midi_table_cx[m]);
+        worst=e>worst?e:worst;
+    }
+    return worst;
+}
+
+// a cent is 578 ppm
+static_assert(tone_worst_ppm()<5, "notes out of tune at TONE_CLK_HZ");
+
+extern "C" const pwm_freq_t *const tone_midi_table=tone_midi_table_cx.data();
@@ -0,0 +1,139 @@
+/**
+* @file input_trace.c
+*
+* replays a trace of pin edges through the debounce state machine of input.h
+*
+* trace format: one edge per line, "time_us gpio level" ("1000 22 0"), a line with only a time
+* advances the clock to it (to see long presses and repeats), '#' starts a comment
+*
+*   input_trace [-d debounce_us] [-l long_us] [-r repeat_us] [-H] trace.txt
+*
+* pins are active low unless -H is given, every pin starts released
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "input.h"
+
+#define INPUT_TRACE_GPIOS 32
+
+static const char *const input_trace_names[]= {
+    [INPUT_PRESS]="press",
+    [INPUT_RELEASE]="release",
+    [INPUT_LONG]="long",
+    [INPUT_REPEAT]="repeat",
+};
+
+static input_pin_t pins[INPUT_TRACE_GPIOS];
+static bool used[INPUT_TRACE_GPIOS];
+static input_queue_t queue;
+
+static void report(void) {
+    input_event_t e;
+    while(input_queue_pop(&queue, &e)) {
+        printf("%10llu us  gpio %2u  %s", (unsigned long long) e.time_us, e.gpio, input_trace_names[e.type]);
+        if(e.type!=INPUT_PRESS)
+            printf("%*sheld %lu us", (int) (9-strlen(input_trace_names[e.type])), "", (unsigned long) e.held_us);
+        if(e.type==INPUT_REPEAT)
+            printf("  #%u", e.repeat);
+        putchar('\n');
+    }
+}
+
+// runs every pin to a time, deadlines in between produce their events
+static void advance(uint64_t until) {
+    for(;;) {
+        uint64_t next=INPUT_NEVER;
+        for(uint32_t i=0; i<INPUT_TRACE_GPIOS; ++i) {
+            if(used[i]) {
+                const uint64_t t=input_pin_timeout(&pins[i], until, &queue);
+                if(t<next)
+                    next=t;
+            }
+        }
+        report();
+        if(next>until)
+            return;
+    }
+}
+
+int main(int argc, char **argv) {
+    uint32_t debounce_us=INPUT_DEBOUNCE_US, long_us=INPUT_LONG_US, repeat_us=INPUT_REPEAT_US;
+    bool active_low=true;
+    const char *in=NULL;
+
+    for(int i=1; i<argc; ++i) {
+        if(i+1<argc && !strcmp(argv[i], "-d"))
+            debounce_us=strtoul(argv[++i], NULL, 0);
+        else if(i+1<argc && !strcmp(argv[i], "-l"))
+            long_us=strtoul(argv[++i], NULL, 0);
+        else if(i+1<argc && !strcmp(argv[i], "-r"))
+            repeat_us=strtoul(argv[++i], NULL, 0);
+        else if(!strcmp(argv[i], "-H"))
+            active_low=false;
+        else
+            in=argv[i];
+    }
+
+    if(!in) {
+        fprintf(stderr, "usage: %s [-d debounce_us] [-l long_us] [-r repeat_us] [-H] trace.txt\n", argv[0]);
+        return 2;
+    }
+
+    FILE *f=strcmp(in, "-")?fopen(in, "r"):stdin;
+    if(!f) {
+        perror(in);
+        return 1;
+    }
+
+    uint64_t now=0;
+    uint32_t edges=0;
+    char line[256];
+
+    while(fgets(line, sizeof(line), f)) {
+        char *hash=strchr(line, '#');
+        if(hash)
+            *hash=0;
+
+        unsigned long long time;
+        unsigned gpio, level;
+        const int n=sscanf(line, "%llu %u %u", &time, &gpio, &level);
+        if(n<1)
+            continue;
+        if(time<now) {
+            fprintf(stderr, "%s: time %llu goes backwards\n", in, time);
+            return 1;
+        }
+
+        now=time;
+        advance(now);
+        if(n<3)
+            continue;
+
+        if(gpio>=INPUT_TRACE_GPIOS) {
+            fprintf(stderr, "%s: gpio %u out of range\n", in, gpio);
+            return 1;
+        }
+        if(!used[gpio]) {
+            input_pin_init(&pins[gpio], gpio, active_low);
+            pins[gpio].debounce_us=debounce_us;
+            pins[gpio].long_us=long_us;
+            pins[gpio].repeat_us=repeat_us;
+            used[gpio]=true;
+        }
+
+        input_pin_edge(&pins[gpio], level, now, &queue);
+        report();
+        ++edges;
+    }
+    if(f!=stdin)
+        fclose(f);
+
+    // windows still open at the end of the trace
+    advance(now+debounce_us);
+
+    printf("total: %u edges, %lu events dropped\n", edges, (unsigned long) queue.dropped);
+    return 0;
+}
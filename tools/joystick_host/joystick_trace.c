@@ -0,0 +1,113 @@
+/**
+* @file joystick_trace.c
+*
+* feeds a trace of stick positions through the conditioning of joystick.h
+*
+* trace format: one position per line, "time_us raw_x raw_y" ("200000 4095 2048"); the stick
+* holds it until the next line and is sampled every -s us in between, '#' starts a comment
+*
+*   joystick_trace [-s sample_us] trace.txt
+*
+* prints the end of the calibration, every direction step with the time since the previous
+* one, and the conditioned position at the end of every line
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "joystick.h"
+
+static const char *const joystick_trace_names[]= {"up", "down", "left", "right"};
+
+static joystick_t stick;
+static uint64_t last_step;
+
+static void sample(uint16_t raw_x, uint16_t raw_y, uint64_t now) {
+    const bool was_calibrated=joystick_calibrated(&stick);
+    const uint32_t steps=joystick_update(&stick, raw_x, raw_y, now);
+
+    if(!was_calibrated && joystick_calibrated(&stick))
+        printf("%10llu us  calibrated  center x %ld y %ld\n", (unsigned long long) now,
+               (long) (stick.x.center>>8), (long) (stick.y.center>>8));
+
+    for(uint32_t i=0; i<4; ++i) {
+        if(!(steps&(1u<<i)))
+            continue;
+        printf("%10llu us  %-5s       +%llu us\n", (unsigned long long) now, joystick_trace_names[i],
+               (unsigned long long) (now-last_step));
+        last_step=now;
+    }
+}
+
+static void position(uint64_t now) {
+    printf("%10llu us  position    x %5d y %5d  dir %2d %2d\n", (unsigned long long) now,
+           stick.x.value, stick.y.value, stick.x.dir, stick.y.dir);
+}
+
+int main(int argc, char **argv) {
+    uint32_t sample_us=1000;
+    const char *in=NULL;
+
+    for(int i=1; i<argc; ++i) {
+        if(i+1<argc && !strcmp(argv[i], "-s"))
+            sample_us=strtoul(argv[++i], NULL, 0);
+        else
+            in=argv[i];
+    }
+
+    if(!in || !sample_us) {
+        fprintf(stderr, "usage: %s [-s sample_us] trace.txt\n", argv[0]);
+        return 2;
+    }
+
+    FILE *f=strcmp(in, "-")?fopen(in, "r"):stdin;
+    if(!f) {
+        perror(in);
+        return 1;
+    }
+
+    joystick_init(&stick);
+
+    uint64_t now=0;
+    bool held=false;
+    unsigned raw_x=0, raw_y=0;
+    char line[256];
+
+    while(fgets(line, sizeof(line), f)) {
+        char *hash=strchr(line, '#');
+        if(hash)
+            *hash=0;
+
+        unsigned long long time;
+        unsigned x, y;
+        if(sscanf(line, "%llu %u %u", &time, &x, &y)!=3)
+            continue;
+        if(time<now) {
+            fprintf(stderr, "%s: time %llu goes backwards\n", in, time);
+            return 1;
+        }
+
+        // the previous position up to this line
+        if(held) {
+            for(; now<time; now+=sample_us)
+                sample(raw_x, raw_y, now);
+            position(now);
+        }
+        now=time;
+        raw_x=x;
+        raw_y=y;
+        held=true;
+    }
+    if(f!=stdin)
+        fclose(f);
+
+    // the last position for one more repeat delay
+    if(held) {
+        const uint64_t end=now+stick.repeat_delay_us;
+        for(; now<end; now+=sample_us)
+            sample(raw_x, raw_y, now);
+        position(now);
+    }
+    return 0;
+}
@@ -0,0 +1,67 @@
+/**
+* @file dma.h
+*
+* host stand-in for hardware/dma.h: there are no channels to claim, so code falls back to
+* its CPU paths or to a host transport
+*/
+
+#ifndef _inc_pico_host_dma
+#define _inc_pico_host_dma
+
+#include <pico/stdlib.h>
+
+typedef struct {
+    uint32_t ctrl;
+} dma_channel_config;
+
+enum {
+    DMA_SIZE_8,
+    DMA_SIZE_16,
+    DMA_SIZE_32,
+};
+
+static inline int dma_claim_unused_channel(bool required) {
+    (void) required;
+    return -1;
+}
+
+static inline void dma_channel_abort(uint channel) {
+    (void) channel;
+}
+
+static inline dma_channel_config dma_channel_get_default_config(uint channel) {
+    (void) channel;
+    return (dma_channel_config) {0};
+}
+
+static inline void channel_config_set_transfer_data_size(dma_channel_config *c, uint size) {
+    (void) c;
+    (void) size;
+}
+
+static inline void channel_config_set_read_increment(dma_channel_config *c, bool incr) {
+    (void) c;
+    (void) incr;
+}
+
+static inline void channel_config_set_write_increment(dma_channel_config *c, bool incr) {
+    (void) c;
+    (void) incr;
+}
+
+static inline void channel_config_set_dreq(dma_channel_config *c, uint dreq) {
+    (void) c;
+    (void) dreq;
+}
+
+static inline void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+        const volatile void *read_addr, uint count, bool trigger) {
+    (void) channel;
+    (void) config;
+    (void) write_addr;
+    (void) read_addr;
+    (void) count;
+    (void) trigger;
+}
+
+#endif
@@ -0,0 +1,48 @@
+/**
+* @file i2c.h
+*
+* host stand-in for hardware/i2c.h: no device answers, displays use a host transport
+*/
+
+#ifndef _inc_pico_host_i2c
+#define _inc_pico_host_i2c
+
+#include <pico/stdlib.h>
+
+typedef struct {
+    volatile uint32_t enable, tar, intr_stat, clr_tx_abrt, clr_stop_det, intr_mask, data_cmd;
+} i2c_hw_t;
+
+typedef struct i2c_inst {
+    i2c_hw_t *hw;
+    uint index;
+} i2c_inst_t;
+
+extern i2c_inst_t i2c0_inst, i2c1_inst;
+
+#define i2c0 (&i2c0_inst)
+#define i2c1 (&i2c1_inst)
+
+#define I2C_IC_INTR_STAT_R_TX_ABRT_BITS 0x40
+#define I2C_IC_INTR_STAT_R_STOP_DET_BITS 0x200
+#define I2C_IC_INTR_MASK_M_TX_ABRT_BITS 0x40
+#define I2C_IC_INTR_MASK_M_STOP_DET_BITS 0x200
+#define I2C_IC_DATA_CMD_RESTART_BITS 0x400
+#define I2C_IC_DATA_CMD_STOP_BITS 0x200
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate);
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop);
+
+static inline uint i2c_get_index(i2c_inst_t *i2c) {
+    return i2c->index;
+}
+
+static inline i2c_hw_t *i2c_get_hw(i2c_inst_t *i2c) {
+    return i2c->hw;
+}
+
+static inline uint i2c_get_dreq(i2c_inst_t *i2c, bool is_tx) {
+    return i2c->index*2+!is_tx;
+}
+
+#endif
@@ -0,0 +1,29 @@
+/**
+* @file irq.h
+*
+* host stand-in for hardware/irq.h, handlers are never called
+*/
+
+#ifndef _inc_pico_host_irq
+#define _inc_pico_host_irq
+
+#include <pico/stdlib.h>
+
+enum {
+    I2C0_IRQ=23,
+    I2C1_IRQ=24,
+};
+
+typedef void (*irq_handler_t)(void);
+
+static inline void irq_set_exclusive_handler(uint num, irq_handler_t handler) {
+    (void) num;
+    (void) handler;
+}
+
+static inline void irq_set_enabled(uint num, bool enabled) {
+    (void) num;
+    (void) enabled;
+}
+
+#endif
@@ -0,0 +1,24 @@
+/**
+* @file sync.h
+*
+* host stand-in for hardware/sync.h: one thread, no interrupts to mask
+*/
+
+#ifndef _inc_pico_host_sync
+#define _inc_pico_host_sync
+
+#include <pico/stdlib.h>
+
+static inline uint32_t save_and_disable_interrupts(void) {
+    return 0;
+}
+
+static inline void restore_interrupts(uint32_t status) {
+    (void) status;
+}
+
+static inline void __wfe(void) {}
+
+static inline void __sev(void) {}
+
+#endif
@@ -0,0 +1,5 @@
+/**
+* @file binary_info.h
+*
+* host stand-in for pico/binary_info.h, binary info is not kept
+*/
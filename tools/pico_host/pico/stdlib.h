@@ -0,0 +1,60 @@
+/**
+* @file stdlib.h
+*
+* host stand-in for the parts of pico/stdlib.h the modules use, see pico_host.c
+*/
+
+#ifndef _inc_pico_host_stdlib
+#define _inc_pico_host_stdlib
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef unsigned int uint;
+typedef uint64_t absolute_time_t;
+
+#define PICO_ERROR_GENERIC -1
+#define PICO_ERROR_TIMEOUT -2
+
+/**
+*	@brief host time, starts at 0 and only moves with sleep_ms/sleep_us/pico_host_advance
+*/
+uint64_t time_us_64(void);
+uint32_t time_us_32(void);
+void sleep_ms(uint32_t ms);
+void sleep_us(uint64_t us);
+
+/**
+	@brief move the host time forward
+
+	@param[in] us : time span
+*/
+void pico_host_advance(uint64_t us);
+
+static inline void tight_loop_contents(void) {}
+
+static inline absolute_time_t from_us_since_boot(uint64_t us) {
+    return us;
+}
+
+static inline uint64_t to_us_since_boot(absolute_time_t t) {
+    return t;
+}
+
+// there is nothing to wait for on host: the timeout has passed
+static inline bool best_effort_wfe_or_timeout(absolute_time_t t) {
+    if(t>time_us_64())
+        pico_host_advance(t-time_us_64());
+    return true;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
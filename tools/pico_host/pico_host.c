@@ -0,0 +1,47 @@
+/**
+* @file pico_host.c
+*
+* host stand-ins for the SDK functions the modules call, for the host builds under tools/
+*/
+
+#include <pico/stdlib.h>
+#include <hardware/i2c.h>
+
+static uint64_t pico_host_time;
+
+uint64_t time_us_64(void) {
+    return pico_host_time;
+}
+
+uint32_t time_us_32(void) {
+    return (uint32_t) pico_host_time;
+}
+
+void pico_host_advance(uint64_t us) {
+    pico_host_time+=us;
+}
+
+void sleep_ms(uint32_t ms) {
+    pico_host_time+=ms*1000ull;
+}
+
+void sleep_us(uint64_t us) {
+    pico_host_time+=us;
+}
+
+static i2c_hw_t pico_host_i2c_hw[2];
+i2c_inst_t i2c0_inst= {&pico_host_i2c_hw[0], 0}, i2c1_inst= {&pico_host_i2c_hw[1], 1};
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate) {
+    (void) i2c;
+    return baudrate;
+}
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+    (void) i2c;
+    (void) addr;
+    (void) src;
+    (void) len;
+    (void) nostop;
+    return PICO_ERROR_GENERIC;
+}
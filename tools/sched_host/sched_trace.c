@@ -0,0 +1,78 @@
+/**
+* @file sched_trace.c
+*
+* runs sched.c on the virtual clock with periodic and signalled tasks and prints their latency
+*
+*   sched_trace [-t run_us] [-v]
+*
+* a slow display task (10 ms period, 3 ms of CPU) delays a fast sampling task (1 ms period,
+* 50 us); a modeled button interrupt every 7.3 ms signals a third task. -v prints every run
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sched.h"
+#include "sched_virtual_clock.h"
+
+#define TRACE_EVENT_BUTTON 1
+#define TRACE_BUTTON_US 7300
+
+static bool verbose;
+
+typedef struct {
+    uint32_t period_us;	// 0: runs on TRACE_EVENT_BUTTON
+    uint32_t cpu_us;	// CPU time of one run
+} trace_job_t;
+
+static const trace_job_t display_job= {10000, 3000};
+static const trace_job_t sample_job= {1000, 50};
+static const trace_job_t button_job= {0, 100};
+
+static sched_task_t display_task, sample_task, button_task;
+
+static void trace_task(sched_task_t *t) {
+    const trace_job_t *job=t->arg;
+    if(verbose)
+        printf("%10llu us  %-8s %s\n", (unsigned long long) sched_virtual_now(), t->name,
+               t->fired?"signalled":"timer");
+    sched_virtual_spend(job->cpu_us);
+}
+
+static void trace_button_irq(void *arg) {
+    (void) arg;
+    sched_signal(&button_task, TRACE_EVENT_BUTTON);
+    sched_virtual_irq(sched_virtual_now()+TRACE_BUTTON_US, trace_button_irq, NULL);
+}
+
+int main(int argc, char **argv) {
+    uint64_t run_us=1000000;
+
+    for(int i=1; i<argc; ++i) {
+        if(i+1<argc && !strcmp(argv[i], "-t"))
+            run_us=strtoull(argv[++i], NULL, 0);
+        else if(!strcmp(argv[i], "-v"))
+            verbose=true;
+        else {
+            fprintf(stderr, "usage: %s [-t run_us] [-v]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    sched_virtual_reset(0);
+    sched_init(&sched_virtual_clock);
+
+    sched_add(&display_task, "display", trace_task, (void *) &display_job);
+    sched_every(&display_task, display_job.period_us);
+    sched_add(&sample_task, "sample", trace_task, (void *) &sample_job);
+    sched_every(&sample_task, sample_job.period_us);
+    sched_add(&button_task, "button", trace_task, (void *) &button_job);
+    sched_wait(&button_task, TRACE_EVENT_BUTTON);
+
+    sched_virtual_irq(TRACE_BUTTON_US, trace_button_irq, NULL);
+
+    sched_run_for(run_us);
+    sched_dump("trace");
+    return 0;
+}
@@ -0,0 +1,88 @@
+/**
+* @file sched_virtual_clock.c
+*
+* virtual time for host builds of sched.c
+*/
+
+#include <stddef.h>
+
+#include "sched_virtual_clock.h"
+
+static uint64_t sched_virtual_time;
+
+static struct {
+    uint64_t at;
+    void (*handler)(void *arg);
+    void *arg;
+} sched_virtual_irqs[SCHED_VIRTUAL_MAX_IRQS];
+static uint32_t sched_virtual_irq_count;
+
+// earliest pending interrupt, -1 if none
+static int32_t sched_virtual_next_irq(void) {
+    int32_t next=-1;
+    for(uint32_t i=0; i<sched_virtual_irq_count; ++i)
+        if(next<0 || sched_virtual_irqs[i].at<sched_virtual_irqs[next].at)
+            next=i;
+    return next;
+}
+
+// moves the clock to until, taking the interrupts on the way at their time
+static void sched_virtual_advance(uint64_t until, bool stop_at_irq) {
+    for(;;) {
+        const int32_t i=sched_virtual_next_irq();
+        if(i<0 || sched_virtual_irqs[i].at>until)
+            break;
+
+        if(sched_virtual_irqs[i].at>sched_virtual_time)
+            sched_virtual_time=sched_virtual_irqs[i].at;
+
+        void (*handler)(void *)=sched_virtual_irqs[i].handler;
+        void *arg=sched_virtual_irqs[i].arg;
+        sched_virtual_irqs[i]=sched_virtual_irqs[--sched_virtual_irq_count];
+        handler(arg);
+
+        // an interrupt wakes the idle CPU
+        if(stop_at_irq)
+            return;
+    }
+
+    if(until!=SCHED_NEVER && until>sched_virtual_time)
+        sched_virtual_time=until;
+}
+
+static uint64_t sched_virtual_clock_now(void) {
+    return sched_virtual_time;
+}
+
+static void sched_virtual_clock_idle(uint64_t until) {
+    sched_virtual_advance(until, true);
+}
+
+const sched_clock_t sched_virtual_clock= {
+    .now=sched_virtual_clock_now,
+    .idle=sched_virtual_clock_idle,
+};
+
+void sched_virtual_reset(uint64_t us) {
+    sched_virtual_time=us;
+    sched_virtual_irq_count=0;
+}
+
+uint64_t sched_virtual_now(void) {
+    return sched_virtual_time;
+}
+
+void sched_virtual_spend(uint64_t us) {
+    sched_virtual_advance(sched_virtual_time+us, false);
+}
+
+bool sched_virtual_irq(uint64_t at, void (*handler)(void *arg), void *arg) {
+    if(sched_virtual_irq_count==SCHED_VIRTUAL_MAX_IRQS)
+        return false;
+
+    sched_virtual_irqs[sched_virtual_irq_count].at=at;
+    sched_virtual_irqs[sched_virtual_irq_count].handler=handler;
+    sched_virtual_irqs[sched_virtual_irq_count].arg=arg;
+    ++sched_virtual_irq_count;
+    return true;
+}
@@ -0,0 +1,69 @@
+/**
+* @file sched_virtual_clock.h
+*
+* virtual time for host builds of sched.c
+*
+* the clock stands still while tasks run unless they account for their CPU time with
+* sched_virtual_spend; idle jumps straight to the next timer. interrupts are modeled as
+* callbacks at fixed virtual times (sched_virtual_irq), typically calling sched_signal, so
+* the latency from an event to the task run is measured in exact microseconds
+*/
+
+#ifndef _inc_sched_virtual_clock
+#define _inc_sched_virtual_clock
+
+#include "sched.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+*	@brief maximum number of pending modeled interrupts
+*/
+#ifndef SCHED_VIRTUAL_MAX_IRQS
+#define SCHED_VIRTUAL_MAX_IRQS 16
+#endif
+
+/**
+*	@brief clock for sched_init
+*/
+extern const sched_clock_t sched_virtual_clock;
+
+/**
+	@brief set the time, drops pending interrupts
+
+	@param[in] us : new time
+*/
+void sched_virtual_reset(uint64_t us);
+
+/**
+	@brief current virtual time
+
+	@return microseconds
+*/
+uint64_t sched_virtual_now(void);
+
+/**
+	@brief advance the time by CPU time spent in a task, interrupts due meanwhile are taken
+
+	@param[in] us : time spent
+*/
+void sched_virtual_spend(uint64_t us);
+
+/**
+	@brief model an interrupt
+
+	@param[in] at : virtual time it fires
+	@param[in] handler : called when the time is reached
+	@param[in] arg : argument of handler
+
+	@return false if SCHED_VIRTUAL_MAX_IRQS are pending already
+*/
+bool sched_virtual_irq(uint64_t at, void (*handler)(void *arg), void *arg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
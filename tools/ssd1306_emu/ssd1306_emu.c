@@ -0,0 +1,361 @@
+/**
+* @file ssd1306_emu.c
+*
+* host side model of an SSD1306 controller
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ssd1306_emu.h"
+
+void ssd1306_emu_init(ssd1306_emu_t *e, uint8_t address, uint8_t width, uint8_t height) {
+    memset(e, 0, sizeof(*e));
+    e->address=address;
+    e->width=width>128?128:width;
+    e->height=height>64?64:height;
+
+    // reset values from the datasheet
+    e->mem_mode=2;
+    e->col_end=127;
+    e->page_end=7;
+    e->contrast=0x7f;
+    e->mux=63;
+}
+
+// total length of a command including its parameters
+static uint8_t ssd1306_emu_cmd_length(uint8_t cmd) {
+    switch(cmd) {
+    case 0x20: // memory addressing mode
+    case 0x81: // contrast
+    case 0x8d: // charge pump
+    case 0xa8: // multiplex ratio
+    case 0xd3: // display offset
+    case 0xd5: // clock divide
+    case 0xd9: // precharge
+    case 0xda: // com pins
+    case 0xdb: // vcomh
+        return 2;
+    case 0x21: // column address
+    case 0x22: // page address
+    case 0xa3: // vertical scroll area
+        return 3;
+    case 0x29: // vertical and horizontal scroll setup
+    case 0x2a:
+        return 6;
+    case 0x26: // horizontal scroll setup
+    case 0x27:
+        return 7;
+    default:
+        return 1;
+    }
+}
+
+static void ssd1306_emu_command(ssd1306_emu_t *e) {
+    const uint8_t *c=e->cmd;
+
+    switch(c[0]) {
+    case 0x20:
+        e->mem_mode=c[1]&0x03;
+        return;
+    case 0x21:
+        e->col_start=c[1]&0x7f;
+        e->col_end=c[2]&0x7f;
+        e->col=e->col_start;
+        return;
+    case 0x22:
+        e->page_start=c[1]&0x07;
+        e->page_end=c[2]&0x07;
+        e->page=e->page_start;
+        return;
+    case 0x2e:
+        e->scrolling=false;
+        return;
+    case 0x2f:
+        e->scrolling=true;
+        return;
+    case 0x81:
+        e->contrast=c[1];
+        return;
+    case 0x8d:
+        e->charge_pump=c[1]&0x04;
+        return;
+    case 0xa0:
+    case 0xa1:
+        e->seg_remap=c[0]&0x01;
+        return;
+    case 0xa4:
+    case 0xa5:
+        e->entire_on=c[0]&0x01;
+        return;
+    case 0xa6:
+    case 0xa7:
+        e->invert=c[0]&0x01;
+        return;
+    case 0xa8:
+        e->mux=c[1]&0x3f;
+        return;
+    case 0xae:
+    case 0xaf:
+        e->display_on=c[0]&0x01;
+        return;
+    case 0xc0:
+    case 0xc8:
+        e->com_remap=c[0]&0x08;
+        return;
+    case 0xd3:
+        e->offset=c[1]&0x3f;
+        return;
+    }
+
+    if(c[0]<=0x0f) // page mode: lower nibble of column
+        e->col=(e->col&0xf0)|c[0];
+    else if(c[0]<=0x1f) // page mode: upper nibble of column
+        e->col=((c[0]&0x07)<<4)|(e->col&0x0f);
+    else if(c[0]>=0x40 && c[0]<=0x7f)
+        e->start_line=c[0]&0x3f;
+    else if(c[0]>=0xb0 && c[0]<=0xb7) // page mode: page
+        e->page=c[0]&0x07;
+}
+
+static void ssd1306_emu_command_byte(ssd1306_emu_t *e, uint8_t b) {
+    ++e->frame.command_bytes;
+
+    if(!e->cmd_len)
+        e->cmd_need=ssd1306_emu_cmd_length(b);
+    e->cmd[e->cmd_len++]=b;
+
+    if(e->cmd_len==e->cmd_need) {
+        ssd1306_emu_command(e);
+        e->cmd_len=0;
+    }
+}
+
+static void ssd1306_emu_data_byte(ssd1306_emu_t *e, uint8_t b) {
+    ++e->frame.data_bytes;
+    e->ram[e->page&0x07][e->col&0x7f]=b;
+
+    switch(e->mem_mode) {
+    case 0: // horizontal: along the column window, then next page
+        if(e->col++>=e->col_end) {
+            e->col=e->col_start;
+            if(e->page++>=e->page_end)
+                e->page=e->page_start;
+        }
+        break;
+    case 1: // vertical: along the page window, then next column
+        if(e->page++>=e->page_end) {
+            e->page=e->page_start;
+            if(e->col++>=e->col_end)
+                e->col=e->col_start;
+        }
+        break;
+    default: // page: the column wraps, the page stays
+        e->col=(e->col+1)&0x7f;
+        break;
+    }
+}
+
+bool ssd1306_emu_write(ssd1306_emu_t *e, uint8_t address, const uint8_t *src, size_t len) {
+    if(address!=e->address) {
+        // address byte, not acknowledged, stop
+        ++e->frame.nacks;
+        ++e->frame.bytes;
+        e->frame.bits+=2+9;
+        return false;
+    }
+
+    ++e->frame.transactions;
+    e->frame.bytes+=1+len;
+    e->frame.bits+=2+9*(1+len);
+
+    // control byte: Co=0 makes the rest of the transaction one stream, Co=1 a single byte
+    for(size_t i=0; i<len;) {
+        const uint8_t control=src[i++];
+        ++e->frame.control_bytes;
+
+        const bool data=control&0x40;
+        const size_t end=control&0x80?(i+1<len?i+1:len):len;
+        for(; i<end; ++i) {
+            if(data)
+                ssd1306_emu_data_byte(e, src[i]);
+            else
+                ssd1306_emu_command_byte(e, src[i]);
+        }
+    }
+    return true;
+}
+
+bool ssd1306_emu_write_words(ssd1306_emu_t *e, uint8_t address, const uint16_t *words, size_t len) {
+    bool ok=true;
+    uint8_t *buf=malloc(len?len:1);
+    if(!buf)
+        return false;
+
+    size_t n=0;
+    for(size_t i=0; i<len; ++i) {
+        if(words[i]&0x400 && n) { // RESTART: the previous transaction ends here
+            ok&=ssd1306_emu_write(e, address, buf, n);
+            n=0;
+        }
+        buf[n++]=words[i];
+        if(words[i]&0x200) { // STOP
+            ok&=ssd1306_emu_write(e, address, buf, n);
+            n=0;
+        }
+    }
+    if(n)
+        ok&=ssd1306_emu_write(e, address, buf, n);
+
+    free(buf);
+    return ok;
+}
+
+void ssd1306_emu_end_frame(ssd1306_emu_t *e, ssd1306_emu_stats_t *stats) {
+    if(stats)
+        *stats=e->frame;
+
+    e->total.transactions+=e->frame.transactions;
+    e->total.bytes+=e->frame.bytes;
+    e->total.control_bytes+=e->frame.control_bytes;
+    e->total.command_bytes+=e->frame.command_bytes;
+    e->total.data_bytes+=e->frame.data_bytes;
+    e->total.nacks+=e->frame.nacks;
+    e->total.bits+=e->frame.bits;
+    memset(&e->frame, 0, sizeof(e->frame));
+}
+
+uint32_t ssd1306_emu_bus_time_us(const ssd1306_emu_stats_t *stats, uint32_t i2c_hz) {
+    return i2c_hz?(stats->bits*1000000ull+i2c_hz-1)/i2c_hz:0;
+}
+
+bool ssd1306_emu_pixel(const ssd1306_emu_t *e, uint32_t x, uint32_t y) {
+    if(!e->display_on || x>=e->width || y>=e->height || y>e->mux)
+        return false;
+
+    // upright for the SEG remap / COM direction ssd1306_init() sets
+    const uint32_t col=(128-e->width)/2+x;
+    const uint32_t ram_col=e->seg_remap?col:127-col;
+    const uint32_t row=e->com_remap?y:e->mux-y;
+    const uint32_t ram_row=(row+e->start_line+e->offset)&0x3f;
+
+    bool lit=e->entire_on || (e->ram[ram_row>>3][ram_col]>>(ram_row&0x07))&1;
+    return lit!=e->invert;
+}
+
+bool ssd1306_emu_save_pbm(const ssd1306_emu_t *e, const char *path) {
+    FILE *f=fopen(path, "wb");
+    if(!f)
+        return false;
+
+    fprintf(f, "P4\n%u %u\n", e->width, e->height);
+    for(uint32_t y=0; y<e->height; ++y) {
+        for(uint32_t x=0; x<e->width; x+=8) {
+            uint8_t b=0;
+            for(uint32_t i=0; i<8 && x+i<e->width; ++i)
+                if(ssd1306_emu_pixel(e, x+i, y))
+                    b|=0x80>>i;
+            fputc(b, f);
+        }
+    }
+    return fclose(f)==0;
+}
+
+static uint32_t ssd1306_emu_crc32(uint32_t crc, const uint8_t *src, size_t len) {
+    crc=~crc;
+    while(len--) {
+        crc^=*src++;
+        for(int i=0; i<8; ++i)
+            crc=crc>>1^(0xedb88320u&-(crc&1));
+    }
+    return ~crc;
+}
+
+static void ssd1306_emu_put32(uint8_t *d, uint32_t v) {
+    d[0]=v>>24;
+    d[1]=v>>16;
+    d[2]=v>>8;
+    d[3]=v;
+}
+
+static bool ssd1306_emu_png_chunk(FILE *f, const char *type, const uint8_t *src, size_t len) {
+    uint8_t head[8];
+    ssd1306_emu_put32(head, len);
+    memcpy(head+4, type, 4);
+
+    uint8_t crc[4];
+    ssd1306_emu_put32(crc, ssd1306_emu_crc32(ssd1306_emu_crc32(0, head+4, 4), src, len));
+
+    return fwrite(head, 8, 1, f)==1 && (!len || fwrite(src, len, 1, f)==1) && fwrite(crc, 4, 1, f)==1;
+}
+
+bool ssd1306_emu_save_png(const ssd1306_emu_t *e, const char *path, uint32_t scale) {
+    if(!scale)
+        scale=1;
+
+    // an OLED at contrast 0 is dim, not dark
+    const uint8_t on=80+175*e->contrast/255;
+    const uint32_t w=e->width*scale, h=e->height*scale;
+    const size_t raw_len=(size_t) (w+1)*h;
+
+    // zlib stream of stored deflate blocks: no compressor needed
+    const size_t blocks=(raw_len+65534)/65535;
+    const size_t z_len=2+raw_len+5*blocks+4;
+    uint8_t *raw=malloc(raw_len), *z=malloc(z_len);
+    if(!raw || !z) {
+        free(raw);
+        free(z);
+        return false;
+    }
+
+    uint8_t *r=raw;
+    for(uint32_t y=0; y<h; ++y) {
+        *r++=0; // filter: none
+        for(uint32_t x=0; x<w; ++x)
+            *r++=ssd1306_emu_pixel(e, x/scale, y/scale)?on:0;
+    }
+
+    uint8_t *d=z;
+    *d++=0x78;
+    *d++=0x01;
+    uint32_t a=1, b=0;
+    for(size_t off=0; off<raw_len;) {
+        const size_t n=raw_len-off<65535?raw_len-off:65535;
+        *d++=off+n==raw_len;
+        *d++=n;
+        *d++=n>>8;
+        *d++=~n;
+        *d++=~n>>8;
+        memcpy(d, raw+off, n);
+        d+=n;
+        for(size_t i=0; i<n; ++i) {
+            a=(a+raw[off+i])%65521;
+            b=(b+a)%65521;
+        }
+        off+=n;
+    }
+    ssd1306_emu_put32(d, b<<16|a);
+    d+=4;
+
+    uint8_t ihdr[13];
+    ssd1306_emu_put32(ihdr, w);
+    ssd1306_emu_put32(ihdr+4, h);
+    ihdr[8]=8;	// bit depth
+    ihdr[9]=0;	// greyscale
+    ihdr[10]=ihdr[11]=ihdr[12]=0;
+
+    FILE *f=fopen(path, "wb");
+    bool ok=f!=NULL;
+    if(ok) {
+        ok=fwrite("\x89PNG\r\n\x1a\n", 8, 1, f)==1
+           && ssd1306_emu_png_chunk(f, "IHDR", ihdr, sizeof(ihdr))
+           && ssd1306_emu_png_chunk(f, "IDAT", z, d-z)
+           && ssd1306_emu_png_chunk(f, "IEND", NULL, 0);
+        ok=fclose(f)==0 && ok;
+    }
+
+    free(raw);
+    free(z);
+    return ok;
+}
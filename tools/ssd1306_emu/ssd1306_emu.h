@@ -0,0 +1,166 @@
+/**
+* @file ssd1306_emu.h
+*
+* host side model of an SSD1306 controller
+*
+* feed it the i2c transactions the driver writes (address plus the bytes after it) and it
+* rebuilds GDDRAM and the display state from the control bytes and commands, renders what
+* the panel would show and counts the bytes and bus time spent per frame
+*
+* the panel is assumed to be mounted like the usual 128x64/128x32 modules: SEG remap and
+* COM scan direction as set by ssd1306_init() give an upright image, 64 column panels show
+* RAM columns 32..95. scrolling is recorded but not animated
+*/
+
+#ifndef _inc_ssd1306_emu
+#define _inc_ssd1306_emu
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+*	@brief traffic counters
+*/
+typedef struct {
+    uint32_t transactions;		/**< i2c transactions addressed to the display */
+    uint32_t bytes;				/**< bytes on the wire, address bytes included */
+    uint32_t control_bytes;		/**< control bytes (Co, D/C#) */
+    uint32_t command_bytes;		/**< command and command parameter bytes */
+    uint32_t data_bytes;		/**< GDDRAM bytes */
+    uint32_t nacks;				/**< transactions to another address */
+    uint64_t bits;				/**< bus clocks: start, 9 per byte, stop */
+} ssd1306_emu_stats_t;
+
+/**
+*	@brief controller state
+*/
+typedef struct {
+    uint8_t ram[8][128];		/**< GDDRAM, page by page */
+    uint8_t address;			/**< 7 bit i2c address */
+    uint8_t width;				/**< panel width */
+    uint8_t height;				/**< panel height */
+
+    uint8_t mem_mode;			/**< 0 horizontal, 1 vertical, 2 page addressing */
+    uint8_t col;				/**< column pointer */
+    uint8_t page;				/**< page pointer */
+    uint8_t col_start;			/**< column window (horizontal and vertical mode) */
+    uint8_t col_end;
+    uint8_t page_start;			/**< page window (horizontal and vertical mode) */
+    uint8_t page_end;
+
+    bool display_on;			/**< 0xAF */
+    bool entire_on;				/**< 0xA5: every pixel lit regardless of RAM */
+    bool invert;				/**< 0xA7 */
+    bool seg_remap;				/**< 0xA1 */
+    bool com_remap;				/**< 0xC8 */
+    bool charge_pump;			/**< 0x8D 0x14 */
+    bool scrolling;				/**< 0x2F until 0x2E */
+    uint8_t contrast;			/**< 0x81 */
+    uint8_t mux;				/**< 0xA8, rows-1 */
+    uint8_t start_line;			/**< 0x40-0x7F */
+    uint8_t offset;				/**< 0xD3 */
+
+    uint8_t cmd[8];				/**< command being collected */
+    uint8_t cmd_len;			/**< bytes of cmd received */
+    uint8_t cmd_need;			/**< bytes cmd needs in total */
+
+    ssd1306_emu_stats_t frame;	/**< counters since the last ssd1306_emu_end_frame */
+    ssd1306_emu_stats_t total;	/**< counters since ssd1306_emu_init */
+} ssd1306_emu_t;
+
+/**
+	@brief reset the controller to its power on state
+
+	@param[in] e : emulator instance
+	@param[in] address : 7 bit i2c address it answers to
+	@param[in] width : panel width (128 or 64)
+	@param[in] height : panel height (64, 32 or 16)
+*/
+void ssd1306_emu_init(ssd1306_emu_t *e, uint8_t address, uint8_t width, uint8_t height);
+
+/**
+	@brief process one i2c write transaction
+
+	@param[in] e : emulator instance
+	@param[in] address : 7 bit address the transaction is sent to
+	@param[in] src : bytes after the address byte
+	@param[in] len : number of bytes
+
+	@return false if the address is not acknowledged
+*/
+bool ssd1306_emu_write(ssd1306_emu_t *e, uint8_t address, const uint8_t *src, size_t len);
+
+/**
+	@brief process RP2040 IC_DATA_CMD words as written by a background flush
+
+	RESTART (bit 10) starts a new transaction, STOP (bit 9) ends one
+
+	@param[in] e : emulator instance
+	@param[in] address : 7 bit target address
+	@param[in] words : data command words
+	@param[in] len : number of words
+
+	@return false if any transaction was not acknowledged
+*/
+bool ssd1306_emu_write_words(ssd1306_emu_t *e, uint8_t address, const uint16_t *words, size_t len);
+
+/**
+	@brief close the current frame
+
+	@param[in] e : emulator instance
+	@param[out] stats : counters of the frame, may be NULL
+*/
+void ssd1306_emu_end_frame(ssd1306_emu_t *e, ssd1306_emu_stats_t *stats);
+
+/**
+	@brief estimated bus time of the counted traffic
+
+	@param[in] stats : counters
+	@param[in] i2c_hz : i2c clock, e.g. 400000
+
+	@return microseconds
+*/
+uint32_t ssd1306_emu_bus_time_us(const ssd1306_emu_stats_t *stats, uint32_t i2c_hz);
+
+/**
+	@brief pixel as the panel shows it
+
+	@param[in] e : emulator instance
+	@param[in] x : column on the panel
+	@param[in] y : row on the panel
+
+	@return true if lit
+*/
+bool ssd1306_emu_pixel(const ssd1306_emu_t *e, uint32_t x, uint32_t y);
+
+/**
+	@brief save what the panel shows as binary PBM (lit pixels are black)
+
+	@param[in] e : emulator instance
+	@param[in] path : file to write
+
+	@return false on i/o error
+*/
+bool ssd1306_emu_save_pbm(const ssd1306_emu_t *e, const char *path);
+
+/**
+	@brief save what the panel shows as greyscale PNG, lit pixels as bright as the contrast setting
+
+	@param[in] e : emulator instance
+	@param[in] path : file to write
+	@param[in] scale : size of one pixel in the image
+
+	@return false on i/o error
+*/
+bool ssd1306_emu_save_png(const ssd1306_emu_t *e, const char *path, uint32_t scale);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
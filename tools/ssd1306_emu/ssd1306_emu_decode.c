@@ -0,0 +1,124 @@
+/**
+* @file ssd1306_emu_decode.c
+*
+* replays a captured i2c byte stream through the emulator
+*
+* capture format: one transaction per line, hex bytes, the first one being the 7 bit
+* address ("3c 00 21 00 7f 22 00 07"), "---" ends a frame, '#' starts a comment
+*
+*   ssd1306_emu_decode [-W width] [-H height] [-a address] [-k i2c_hz] [-s scale] [-o out.png|out.pbm] capture.txt
+*
+* a '%' format in the output name (e.g. frame%03u.png) saves every frame
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ssd1306_emu.h"
+
+static bool save(const ssd1306_emu_t *e, const char *pattern, uint32_t frame, uint32_t scale) {
+    char path[256];
+    snprintf(path, sizeof(path), pattern, frame);
+
+    const size_t n=strlen(path);
+    if(n>4 && !strcmp(path+n-4, ".pbm"))
+        return ssd1306_emu_save_pbm(e, path);
+    return ssd1306_emu_save_png(e, path, scale);
+}
+
+static void report(const ssd1306_emu_stats_t *s, uint32_t frame, uint32_t hz) {
+    printf("frame %u: %u transactions, %u bytes (%u control, %u command, %u data), %u nacks, %u us at %u Hz\n",
+           frame, s->transactions, s->bytes, s->control_bytes, s->command_bytes, s->data_bytes, s->nacks,
+           ssd1306_emu_bus_time_us(s, hz), hz);
+}
+
+int main(int argc, char **argv) {
+    uint32_t width=128, height=64, address=0x3c, hz=400000, scale=4;
+    const char *out=NULL, *in=NULL;
+
+    for(int i=1; i<argc; ++i) {
+        if(i+1<argc && !strcmp(argv[i], "-W"))
+            width=strtoul(argv[++i], NULL, 0);
+        else if(i+1<argc && !strcmp(argv[i], "-H"))
+            height=strtoul(argv[++i], NULL, 0);
+        else if(i+1<argc && !strcmp(argv[i], "-a"))
+            address=strtoul(argv[++i], NULL, 16);
+        else if(i+1<argc && !strcmp(argv[i], "-k"))
+            hz=strtoul(argv[++i], NULL, 0);
+        else if(i+1<argc && !strcmp(argv[i], "-s"))
+            scale=strtoul(argv[++i], NULL, 0);
+        else if(i+1<argc && !strcmp(argv[i], "-o"))
+            out=argv[++i];
+        else
+            in=argv[i];
+    }
+
+    if(!in) {
+        fprintf(stderr, "usage: %s [-W width] [-H height] [-a address] [-k i2c_hz] [-s scale] [-o out.png|out.pbm] capture.txt\n", argv[0]);
+        return 2;
+    }
+
+    FILE *f=strcmp(in, "-")?fopen(in, "r"):stdin;
+    if(!f) {
+        perror(in);
+        return 1;
+    }
+
+    ssd1306_emu_t e;
+    ssd1306_emu_init(&e, address, width, height);
+
+    const bool every_frame=out && strchr(out, '%');
+    uint32_t frame=0;
+    bool pending=false;
+    char line[4096];
+    uint8_t bytes[sizeof(line)/2];
+
+    while(fgets(line, sizeof(line), f)) {
+        char *hash=strchr(line, '#');
+        if(hash)
+            *hash=0;
+
+        if(!strncmp(line, "---", 3)) {
+            ssd1306_emu_stats_t s;
+            ssd1306_emu_end_frame(&e, &s);
+            report(&s, frame, hz);
+            if(every_frame && !save(&e, out, frame, scale))
+                perror(out);
+            ++frame;
+            pending=false;
+            continue;
+        }
+
+        size_t n=0;
+        for(char *s=line, *end; n<sizeof(bytes); s=end) {
+            const unsigned long v=strtoul(s, &end, 16);
+            if(end==s)
+                break;
+            bytes[n++]=v;
+        }
+        if(n) {
+            ssd1306_emu_write(&e, bytes[0], bytes+1, n-1);
+            pending=true;
+        }
+    }
+    if(f!=stdin)
+        fclose(f);
+
+    if(pending) {
+        ssd1306_emu_stats_t s;
+        ssd1306_emu_end_frame(&e, &s);
+        report(&s, frame, hz);
+        if(every_frame && !save(&e, out, frame, scale))
+            perror(out);
+    }
+
+    printf("total: %u transactions, %u bytes, %u us at %u Hz\n",
+           e.total.transactions, e.total.bytes, ssd1306_emu_bus_time_us(&e.total, hz), hz);
+
+    if(out && !every_frame && !save(&e, out, 0, scale)) {
+        perror(out);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,356 @@
+/**
+* @file ssd1306_emu_test.c
+*
+* host checks of the driver against the emulator: bus traffic of the batched commands and
+* flushes, text wrapping, image blits, zero sweep arcs, a subsetted RLE font from
+* tools/ssd1306_fontc.py, the eight orientations, nested frames
+*
+*   ssd1306_emu_test
+*
+* prints every failed check and exits with 1 if there was one
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ssd1306.h"
+#include "ssd1306_sprite.h"
+#include "ssd1306_raster.h"
+#include "ssd1306_emu.h"
+#include "ssd1306_emu_transport.h"
+
+// generated at build time from test_font.pbm: '0' and '2' kept, '1' dropped
+#include "test_font.h"
+
+extern const uint8_t font_8x5[];
+
+static uint32_t failures;
+
+#define CHECK(cond) check((cond), #cond, __LINE__)
+
+static void check(bool ok, const char *what, int line) {
+    if(ok)
+        return;
+    printf("line %d: failed: %s\n", line, what);
+    ++failures;
+}
+
+// traffic of one call: counters of the frame closed after it
+#define TRAFFIC(e, stats, call) do { ssd1306_emu_end_frame((e), NULL); call; ssd1306_emu_end_frame((e), (stats)); } while(0)
+
+static void test_batching(void) {
+    static ssd1306_emu_t e;
+    static ssd1306_t disp;
+    ssd1306_emu_stats_t s;
+
+    ssd1306_emu_init(&e, 0x3c, 128, 64);
+    CHECK(ssd1306_emu_attach(&e, &disp));
+
+    // the whole init sequence is one control-prefixed command stream
+    TRAFFIC(&e, &s, CHECK(ssd1306_init_transport(&disp, &ssd1306_emu_transport, 128, 64, 0x3c, i2c1, NULL, NULL)));
+    printf("init: %u transactions, %u bytes\n", s.transactions, s.bytes);
+    CHECK(s.transactions==1);
+    CHECK(s.control_bytes==1);
+    CHECK(e.display_on);
+    // like ssd1306_init, the buffer comes uninitialized
+    ssd1306_clear(&disp);
+
+    // first frame: window commands, then control byte plus 1024 data bytes
+    TRAFFIC(&e, &s, ssd1306_show(&disp));
+    printf("first show: %u transactions, %u bytes\n", s.transactions, s.bytes);
+    CHECK(s.transactions==2);
+    CHECK(s.bytes==1034);
+    CHECK(s.data_bytes==1024);
+
+    // nothing changed, nothing sent
+    TRAFFIC(&e, &s, ssd1306_show(&disp));
+    CHECK(s.transactions==0);
+
+    // one pixel: the same two transactions with a 1 column window
+    ssd1306_draw_pixel(&disp, 10, 20);
+    TRAFFIC(&e, &s, ssd1306_show(&disp));
+    printf("one pixel: %u transactions, %u bytes\n", s.transactions, s.bytes);
+    CHECK(s.transactions==2);
+    CHECK(s.data_bytes==1);
+    CHECK(ssd1306_emu_pixel(&e, 10, 20));
+
+    // commands with parameters are one transaction each
+    TRAFFIC(&e, &s, ssd1306_contrast(&disp, 0x40));
+    CHECK(s.transactions==1);
+    CHECK(e.contrast==0x40);
+
+    TRAFFIC(&e, &s, ssd1306_invert(&disp, 1));
+    CHECK(s.transactions==1);
+    CHECK(e.invert);
+
+    ssd1306_deinit(&disp);
+    ssd1306_emu_detach(&disp);
+}
+
+static void test_wrap(void) {
+    static ssd1306_emu_t e;
+    static ssd1306_t disp;
+
+    ssd1306_emu_init(&e, 0x3c, 128, 64);
+    ssd1306_emu_attach(&e, &disp);
+    ssd1306_init_transport(&disp, &ssd1306_emu_transport, 128, 64, 0x3c, i2c1, NULL, NULL);
+    ssd1306_clear(&disp);
+
+    const uint32_t h=ssd1306_font_height(font_8x5, 1);
+    const uint32_t w=ssd1306_measure_string(font_8x5, 1, "hello world");
+    const char *text="hello world again";
+
+    // the char past the width is a space: the whole line fits
+    const char *rest=ssd1306_draw_string_wrapped(&disp, 0, 0, w, h, 1, font_8x5, text);
+    CHECK(!strcmp(rest, "again"));
+
+    // one pixel narrower: back to the previous space
+    rest=ssd1306_draw_string_wrapped(&disp, 0, 0, w-1, h, 1, font_8x5, text);
+    CHECK(!strcmp(rest, "world again"));
+
+    rest=ssd1306_draw_string_wrapped(&disp, 0, 0, w, 2*h, 1, font_8x5, text);
+    CHECK(!*rest);
+
+    ssd1306_deinit(&disp);
+    ssd1306_emu_detach(&disp);
+}
+
+static void test_blit(void) {
+    static ssd1306_emu_t e;
+    static ssd1306_t disp;
+
+    ssd1306_emu_init(&e, 0x3c, 128, 64);
+    ssd1306_emu_attach(&e, &disp);
+    ssd1306_init_transport(&disp, &ssd1306_emu_transport, 128, 64, 0x3c, i2c1, NULL, NULL);
+    ssd1306_clear(&disp);
+
+    // 2x10 image: column 0 set, column 1 clear, placed across a page boundary
+    static const uint8_t image[]= {0xff, 0x00, 0x03, 0x00};
+    ssd1306_draw_square(&disp, 0, 0, 8, 32);
+    ssd1306_blit_page_image(&disp, 4, 5, image, 2, 10);
+    ssd1306_show(&disp);
+
+    for(uint32_t y=5; y<15; ++y) {
+        CHECK(ssd1306_emu_pixel(&e, 4, y));
+        CHECK(!ssd1306_emu_pixel(&e, 5, y));
+    }
+    // outside of the image the square stays
+    CHECK(ssd1306_emu_pixel(&e, 5, 4));
+    CHECK(ssd1306_emu_pixel(&e, 5, 15));
+    CHECK(ssd1306_emu_pixel(&e, 6, 10));
+
+    ssd1306_deinit(&disp);
+    ssd1306_emu_detach(&disp);
+}
+
+static uint32_t lit_pixels(ssd1306_emu_t *e) {
+    uint32_t n=0;
+    for(uint32_t y=0; y<64; ++y)
+        for(uint32_t x=0; x<128; ++x)
+            n+=ssd1306_emu_pixel(e, x, y);
+    return n;
+}
+
+static void test_arc(void) {
+    static ssd1306_emu_t e;
+    static ssd1306_t disp;
+
+    ssd1306_emu_init(&e, 0x3c, 128, 64);
+    ssd1306_emu_attach(&e, &disp);
+    ssd1306_init_transport(&disp, &ssd1306_emu_transport, 128, 64, 0x3c, i2c1, NULL, NULL);
+
+    // zero sweeps are one point at the start angle, not the opposite one as well
+    static const int32_t angles[][2]= {{0, 0}, {90, 90}, {225, 225}, {390, 30}, {-90, -90}};
+    static const int32_t expect[][2]= {{74, 32}, {64, 42}, {57, 25}, {73, 37}, {64, 22}};
+    for(uint32_t i=0; i<sizeof(angles)/sizeof(angles[0]); ++i) {
+        ssd1306_clear(&disp);
+        ssd1306_draw_arc(&disp, 64, 32, 10, angles[i][0], angles[i][1]);
+        ssd1306_show(&disp);
+        CHECK(lit_pixels(&e)==1);
+        CHECK(ssd1306_emu_pixel(&e, expect[i][0], expect[i][1]));
+    }
+
+    // a quarter keeps both ends and nothing of the opposite side
+    ssd1306_clear(&disp);
+    ssd1306_draw_arc(&disp, 64, 32, 10, 0, 90);
+    ssd1306_show(&disp);
+    CHECK(ssd1306_emu_pixel(&e, 74, 32));
+    CHECK(ssd1306_emu_pixel(&e, 64, 42));
+    CHECK(!ssd1306_emu_pixel(&e, 54, 32));
+    CHECK(!ssd1306_emu_pixel(&e, 64, 22));
+
+    ssd1306_deinit(&disp);
+    ssd1306_emu_detach(&disp);
+}
+
+static void test_rle_font(void) {
+    static ssd1306_emu_t e;
+    static ssd1306_t disp;
+
+    ssd1306_emu_init(&e, 0x3c, 128, 64);
+    ssd1306_emu_attach(&e, &disp);
+    ssd1306_init_transport(&disp, &ssd1306_emu_transport, 128, 64, 0x3c, i2c1, NULL, NULL);
+    ssd1306_clear(&disp);
+
+    // compressed, and the dropped '1' has an empty index entry
+    CHECK(test_font[1]&0x01);
+    CHECK(!test_font[7+3] && !test_font[7+4] && !test_font[7+5]);
+
+    // '0' is 6x12, '1' takes only the spacing, '2' is 4x16 at 6+1+0+1
+    CHECK(ssd1306_measure_string(test_font, 1, "012")==12);
+    ssd1306_draw_string_with_font(&disp, 0, 0, 1, test_font, "012");
+    ssd1306_show(&disp);
+
+    CHECK(ssd1306_emu_pixel(&e, 0, 0) && ssd1306_emu_pixel(&e, 5, 11));
+    CHECK(!ssd1306_emu_pixel(&e, 0, 12) && !ssd1306_emu_pixel(&e, 6, 0) && !ssd1306_emu_pixel(&e, 7, 0));
+    CHECK(ssd1306_emu_pixel(&e, 8, 0) && ssd1306_emu_pixel(&e, 11, 15));
+    CHECK(!ssd1306_emu_pixel(&e, 12, 0));
+
+    ssd1306_deinit(&disp);
+    ssd1306_emu_detach(&disp);
+}
+
+// where drawing coordinates land on the upright 128x64 panel: mirrored, then turned clockwise
+static void panel_xy(ssd1306_rotation_t r, bool mirror, uint32_t w, uint32_t x, uint32_t y, uint32_t *px, uint32_t *py) {
+    if(mirror)
+        x=w-1-x;
+    switch(r) {
+    case SSD1306_ROTATE_90:
+        *px=127-y;
+        *py=x;
+        break;
+    case SSD1306_ROTATE_180:
+        *px=127-x;
+        *py=63-y;
+        break;
+    case SSD1306_ROTATE_270:
+        *px=y;
+        *py=63-x;
+        break;
+    default:
+        *px=x;
+        *py=y;
+        break;
+    }
+}
+
+static void test_rotation(void) {
+    static ssd1306_emu_t e;
+    static ssd1306_t disp;
+
+    ssd1306_emu_init(&e, 0x3c, 128, 64);
+    ssd1306_emu_attach(&e, &disp);
+    ssd1306_init_transport(&disp, &ssd1306_emu_transport, 128, 64, 0x3c, i2c1, NULL, NULL);
+
+    for(uint32_t o=0; o<8; ++o) {
+        const ssd1306_rotation_t r=o>>1;
+        const bool mirror=o&1;
+        CHECK(ssd1306_set_rotation(&disp, r, mirror));
+        CHECK(disp.width==(r&1?64:128) && disp.height==(r&1?128:64));
+
+        // no symmetry: an L in the top left corner, the opposite corner and a point off the diagonal
+        const uint32_t w=disp.width, h=disp.height;
+        const uint32_t pts[][2]= {{0, 0}, {1, 0}, {2, 0}, {0, 1}, {0, 2}, {0, 3}, {w-1, h-1}, {9, 20}};
+        const uint32_t n=sizeof(pts)/sizeof(pts[0]);
+        for(uint32_t i=0; i<n; ++i)
+            ssd1306_draw_pixel(&disp, pts[i][0], pts[i][1]);
+        ssd1306_show(&disp);
+
+        // exactly those panel pixels are lit
+        static bool want[64][128];
+        memset(want, 0, sizeof(want));
+        for(uint32_t i=0; i<n; ++i) {
+            uint32_t px, py;
+            panel_xy(r, mirror, w, pts[i][0], pts[i][1], &px, &py);
+            want[py][px]=true;
+        }
+        uint32_t wrong=0;
+        for(uint32_t y=0; y<64; ++y)
+            for(uint32_t x=0; x<128; ++x)
+                wrong+=ssd1306_emu_pixel(&e, x, y)!=want[y][x];
+        if(wrong)
+            printf("rotation %u%s: %u pixels wrong\n", r*90, mirror?" mirrored":"", wrong);
+        CHECK(!wrong);
+    }
+
+    ssd1306_deinit(&disp);
+    ssd1306_emu_detach(&disp);
+}
+
+static uint32_t frame_cb_calls;
+
+static void frame_cb(ssd1306_t *p, bool ok, void *arg) {
+    (void) p;
+    (void) arg;
+    frame_cb_calls+=ok;
+}
+
+static void test_frames(void) {
+    static ssd1306_emu_t e;
+    static ssd1306_t disp;
+    ssd1306_emu_stats_t s;
+    ssd1306_stats_t st;
+
+    ssd1306_emu_init(&e, 0x3c, 128, 64);
+    ssd1306_emu_attach(&e, &disp);
+    ssd1306_init_transport(&disp, &ssd1306_emu_transport, 128, 64, 0x3c, i2c1, NULL, NULL);
+    ssd1306_clear(&disp);
+    ssd1306_show(&disp);
+    ssd1306_stats_reset(&disp);
+    ssd1306_emu_end_frame(&e, NULL);
+
+    // two nested frames with a show in each: nothing until the outer end
+    ssd1306_begin_frame(&disp);
+    ssd1306_draw_pixel(&disp, 1, 1);
+    ssd1306_begin_frame(&disp);
+    ssd1306_draw_pixel(&disp, 100, 50);
+    ssd1306_show(&disp);
+    ssd1306_end_frame(&disp);
+    ssd1306_show(&disp);
+    ssd1306_emu_end_frame(&e, &s);
+    CHECK(s.transactions==0);
+
+    ssd1306_end_frame(&disp);
+    ssd1306_emu_end_frame(&e, &s);
+    ssd1306_stats_get(&disp, &st);
+    CHECK(st.flushes==1);
+    CHECK(s.transactions>0);
+    CHECK(ssd1306_emu_pixel(&e, 1, 1) && ssd1306_emu_pixel(&e, 100, 50));
+
+    // show_async in a frame: the callback waits for the flush at the end of the frame
+    frame_cb_calls=0;
+    ssd1306_begin_frame(&disp);
+    ssd1306_draw_pixel(&disp, 2, 2);
+    CHECK(ssd1306_show_async(&disp, frame_cb, NULL));
+    CHECK(!ssd1306_show_async(&disp, frame_cb, NULL));
+    ssd1306_emu_end_frame(&e, &s);
+    CHECK(s.transactions==0 && !frame_cb_calls);
+
+    ssd1306_end_frame(&disp);
+    ssd1306_flush_wait(&disp);
+    ssd1306_emu_end_frame(&e, &s);
+    ssd1306_stats_get(&disp, &st);
+    CHECK(frame_cb_calls==1);
+    CHECK(st.flushes==2);
+    CHECK(ssd1306_emu_pixel(&e, 2, 2));
+
+    ssd1306_deinit(&disp);
+    ssd1306_emu_detach(&disp);
+}
+
+int main(void) {
+    test_batching();
+    test_wrap();
+    test_blit();
+    test_arc();
+    test_rle_font();
+    test_rotation();
+    test_frames();
+
+    if(failures) {
+        printf("%u checks failed\n", failures);
+        return 1;
+    }
+    printf("all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,59 @@
+/**
+* @file ssd1306_emu_transport.c
+*
+* driver transport that feeds an ssd1306_emu_t instead of the i2c bus
+*/
+
+#include "ssd1306_emu_transport.h"
+
+static struct {
+    ssd1306_t *p;
+    ssd1306_emu_t *e;
+} ssd1306_emu_attached[SSD1306_EMU_MAX_DISPLAYS];
+
+static ssd1306_emu_t *ssd1306_emu_lookup(ssd1306_t *p) {
+    for(uint32_t i=0; i<SSD1306_EMU_MAX_DISPLAYS; ++i)
+        if(ssd1306_emu_attached[i].p==p)
+            return ssd1306_emu_attached[i].e;
+    return NULL;
+}
+
+static int ssd1306_emu_transport_write(ssd1306_t *p, const uint8_t *src, size_t len) {
+    ssd1306_emu_t *e=ssd1306_emu_lookup(p);
+    if(!e || !ssd1306_emu_write(e, p->address, src, len))
+        return PICO_ERROR_GENERIC;
+    return len;
+}
+
+static bool ssd1306_emu_transport_start(ssd1306_t *p, const uint16_t *words, size_t len) {
+    ssd1306_emu_t *e=ssd1306_emu_lookup(p);
+    if(!e)
+        return false;
+
+    ssd1306_async_done(p, ssd1306_emu_write_words(e, p->address, words, len));
+    return true;
+}
+
+const ssd1306_transport_t ssd1306_emu_transport= {
+    .write=ssd1306_emu_transport_write,
+    .start=ssd1306_emu_transport_start,
+};
+
+bool ssd1306_emu_attach(ssd1306_emu_t *e, ssd1306_t *p) {
+    ssd1306_emu_detach(p);
+
+    for(uint32_t i=0; i<SSD1306_EMU_MAX_DISPLAYS; ++i) {
+        if(!ssd1306_emu_attached[i].p) {
+            ssd1306_emu_attached[i].p=p;
+            ssd1306_emu_attached[i].e=e;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ssd1306_emu_detach(ssd1306_t *p) {
+    for(uint32_t i=0; i<SSD1306_EMU_MAX_DISPLAYS; ++i)
+        if(ssd1306_emu_attached[i].p==p)
+            ssd1306_emu_attached[i].p=NULL;
+}
@@ -0,0 +1,55 @@
+/**
+* @file ssd1306_emu_transport.h
+*
+* driver transport that feeds an ssd1306_emu_t instead of the i2c bus, for host builds
+* of code using ssd1306.c
+*/
+
+#ifndef _inc_ssd1306_emu_transport
+#define _inc_ssd1306_emu_transport
+
+#include "ssd1306.h"
+#include "ssd1306_emu.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+*	@brief maximum number of displays attached to emulators at the same time
+*/
+#ifndef SSD1306_EMU_MAX_DISPLAYS
+#define SSD1306_EMU_MAX_DISPLAYS 4
+#endif
+
+/**
+*	@brief transport writing into the emulator attached with ssd1306_emu_attach
+*/
+extern const ssd1306_transport_t ssd1306_emu_transport;
+
+/**
+	@brief route a display to an emulator
+
+	then initialize with ssd1306_init_transport(p, &ssd1306_emu_transport, ...), so the init
+	sequence reaches the emulator as well. background flushes complete before
+	ssd1306_show_async returns
+
+	@param[in] e : emulator instance
+	@param[in] p : instance of display
+
+	@return false if SSD1306_EMU_MAX_DISPLAYS displays are attached already
+*/
+bool ssd1306_emu_attach(ssd1306_emu_t *e, ssd1306_t *p);
+
+/**
+	@brief undo ssd1306_emu_attach
+
+	@param[in] p : instance of display
+*/
+void ssd1306_emu_detach(ssd1306_t *p);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,105 @@
+/**
+* @file ssd1306_manager_test.c
+*
+* host checks of the flush order, bus budget and skip counting of ssd1306_manager.c, with
+* every display on its own emulator
+*
+*   ssd1306_manager_test
+*
+* prints every failed check and exits with 1 if there was one
+*/
+
+#include <stdio.h>
+
+#include "ssd1306.h"
+#include "ssd1306_manager.h"
+#include "ssd1306_emu.h"
+#include "ssd1306_emu_transport.h"
+
+#define I2C_HZ 400000
+
+static uint32_t failures;
+
+#define CHECK(cond) check((cond), #cond, __LINE__)
+
+static void check(bool ok, const char *what, int line) {
+    if(ok)
+        return;
+    printf("line %d: failed: %s\n", line, what);
+    ++failures;
+}
+
+static ssd1306_emu_t emu[3];
+static ssd1306_t disp[3];
+static ssd1306_manager_t m;
+
+// data bytes each display received since the last call
+static void received(uint32_t *bytes) {
+    for(uint32_t i=0; i<3; ++i) {
+        ssd1306_emu_stats_t s;
+        ssd1306_emu_end_frame(&emu[i], &s);
+        bytes[i]=s.data_bytes;
+    }
+}
+
+int main(void) {
+    uint32_t bytes[3];
+
+    for(uint32_t i=0; i<3; ++i) {
+        ssd1306_emu_init(&emu[i], 0x3c, 128, 64);
+        ssd1306_emu_attach(&emu[i], &disp[i]);
+        ssd1306_init_transport(&disp[i], &ssd1306_emu_transport, 128, 64, 0x3c, i2c1, NULL, NULL);
+        ssd1306_clear(&disp[i]);
+    }
+    received(bytes);
+
+    const uint32_t full=ssd1306_manager_cost_us(&disp[0], I2C_HZ);
+    printf("full frame: %lu us\n", (unsigned long) full);
+
+    // room for one full frame and a little more
+    ssd1306_manager_init(&m, full+full/50);
+    CHECK(!ssd1306_manager_add(&m, &disp[0], 0));
+    for(uint32_t i=0; i<3; ++i)
+        CHECK(ssd1306_manager_add(&m, &disp[i], I2C_HZ));
+
+    // all three fully dirty after init: the first goes, the others wait
+    CHECK(ssd1306_manager_flush(&m)==1);
+    ssd1306_manager_wait(&m);
+    received(bytes);
+    CHECK(bytes[0]==1024 && !bytes[1] && !bytes[2]);
+    CHECK(!m.panels[0].skipped && m.panels[1].skipped==1 && m.panels[2].skipped==1);
+
+    // the waiting displays go first; the small change of display 0 still fits after one of them
+    ssd1306_draw_pixel(&disp[0], 3, 3);
+    CHECK(ssd1306_manager_cost_us(&disp[0], I2C_HZ)<full/50);
+    CHECK(ssd1306_manager_flush(&m)==2);
+    CHECK(m.queue[1][0]==1 && m.queue[1][1]==0);
+    ssd1306_manager_wait(&m);
+    received(bytes);
+    CHECK(bytes[0]==1 && bytes[1]==1024 && !bytes[2]);
+    CHECK(m.panels[2].skipped==2);
+
+    // the last one catches up, nothing else is dirty
+    CHECK(ssd1306_manager_flush(&m)==1);
+    ssd1306_manager_wait(&m);
+    received(bytes);
+    CHECK(!bytes[0] && !bytes[1] && bytes[2]==1024);
+    CHECK(!m.panels[2].skipped);
+
+    // clean displays are not queued at all
+    CHECK(ssd1306_manager_flush(&m)==0);
+    CHECK(!ssd1306_manager_poll(&m));
+
+    for(uint32_t i=0; i<3; ++i) {
+        CHECK(!m.panels[i].failed);
+        ssd1306_deinit(&disp[i]);
+        ssd1306_emu_detach(&disp[i]);
+    }
+
+    if(failures) {
+        printf("%u checks failed\n", failures);
+        return 1;
+    }
+    printf("all checks passed\n");
+    return 0;
+}
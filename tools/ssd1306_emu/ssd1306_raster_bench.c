@@ -0,0 +1,126 @@
+/**
+* @file ssd1306_raster_bench.c
+*
+* host benchmark of ssd1306_draw_line against the float line drawing it replaced
+*
+*   ssd1306_raster_bench [lines]
+*
+* draws the same random lines on a 128x64 buffer with both and prints lines/s and pixels/s.
+* the host has an FPU and the RP2040 does not: there every column of the float path adds
+* soft-float calls, which the host numbers do not show
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "ssd1306.h"
+#include "ssd1306_emu.h"
+#include "ssd1306_emu_transport.h"
+
+// the float line drawing before the integer rasterizer, with its swap fixed
+static void float_draw_line(ssd1306_t *p, int32_t x1, int32_t y1, int32_t x2, int32_t y2) {
+    if(x1>x2) {
+        int32_t t=x1;
+        x1=x2;
+        x2=t;
+        t=y1;
+        y1=y2;
+        y2=t;
+    }
+
+    if(x1==x2) {
+        if(y1>y2) {
+            const int32_t t=y1;
+            y1=y2;
+            y2=t;
+        }
+        for(int32_t i=y1; i<=y2; ++i)
+            ssd1306_draw_pixel(p, x1, i);
+        return;
+    }
+
+    float m=(float) (y2-y1)/(float) (x2-x1);
+
+    for(int32_t i=x1; i<=x2; ++i) {
+        float y=m*(float) (i-x1)+(float) y1;
+        ssd1306_draw_pixel(p, i, (uint32_t) y);
+    }
+}
+
+typedef void (*line_fn_t)(ssd1306_t *p, int32_t x1, int32_t y1, int32_t x2, int32_t y2);
+
+static int32_t (*ends)[4];
+
+static double seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec+ts.tv_nsec*1e-9;
+}
+
+// pixels written per line: the float path one per column, the integer one per step of the
+// longer axis (steep lines have no gaps)
+static uint64_t float_pixels(const int32_t *e) {
+    return e[0]==e[2]?abs(e[3]-e[1])+1:abs(e[2]-e[0])+1;
+}
+
+static uint64_t integer_pixels(const int32_t *e) {
+    const int32_t dx=abs(e[2]-e[0]), dy=abs(e[3]-e[1]);
+    return (dx>dy?dx:dy)+1;
+}
+
+static void bench(ssd1306_t *p, const char *name, line_fn_t fn, uint64_t (*count)(const int32_t *e), uint32_t lines) {
+    uint64_t pixels=0;
+    for(uint32_t i=0; i<lines; ++i)
+        pixels+=count(ends[i]);
+
+    const double t0=seconds();
+    for(uint32_t i=0; i<lines; ++i) {
+        // cleared now and then so the buffer does not saturate
+        if(!(i&63))
+            ssd1306_clear(p);
+        fn(p, ends[i][0], ends[i][1], ends[i][2], ends[i][3]);
+    }
+    const double t=seconds()-t0;
+
+    printf("%-8s %8.3f s  %10.0f lines/s  %12.0f pixels/s\n", name, t, lines/t, pixels/t);
+}
+
+int main(int argc, char **argv) {
+    const uint32_t lines=argc>1?strtoul(argv[1], NULL, 0):1000000;
+    if(!lines) {
+        fprintf(stderr, "usage: %s [lines]\n", argv[0]);
+        return 2;
+    }
+
+    // drawing only touches the buffer, nothing is sent to the emulator while timing
+    static ssd1306_emu_t e;
+    static ssd1306_t disp;
+    ssd1306_emu_init(&e, 0x3c, 128, 64);
+    ssd1306_emu_attach(&e, &disp);
+    if(!ssd1306_init_transport(&disp, &ssd1306_emu_transport, 128, 64, 0x3c, i2c1, NULL, NULL)) {
+        fprintf(stderr, "display init failed\n");
+        return 1;
+    }
+
+    ends=malloc(sizeof(*ends)*lines);
+    if(!ends) {
+        perror("malloc");
+        return 1;
+    }
+    srand(1);
+    for(uint32_t i=0; i<lines; ++i) {
+        ends[i][0]=rand()%128;
+        ends[i][1]=rand()%64;
+        ends[i][2]=rand()%128;
+        ends[i][3]=rand()%64;
+    }
+
+    bench(&disp, "float", float_draw_line, float_pixels, lines);
+    bench(&disp, "integer", ssd1306_draw_line, integer_pixels, lines);
+
+    free(ends);
+    ssd1306_deinit(&disp);
+    ssd1306_emu_detach(&disp);
+    return 0;
+}
@@ -0,0 +1,89 @@
+/**
+* @file ssd1306_rotate_bench.c
+*
+* host benchmark of the 8x8 transposes done per flush when rotated by 90 or 270, against the
+* i2c time of the same flush
+*
+*   ssd1306_rotate_bench [flushes]
+*
+* times full and single block flushes into the emulator upright and rotated by 90; the
+* difference is the transpose. the bus time comes from the emulator's count of clocks at
+* 400 kHz. host times are far below the RP2040's, the ratio to the bus time is the point
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "ssd1306.h"
+#include "ssd1306_emu.h"
+#include "ssd1306_emu_transport.h"
+
+#define I2C_HZ 400000
+
+static ssd1306_emu_t e;
+static ssd1306_t disp;
+
+static double seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec+ts.tv_nsec*1e-9;
+}
+
+// us per flush of the whole buffer (full) or of one 8x8 block, and the bus time of one
+static double bench(ssd1306_rotation_t r, bool full, uint32_t flushes, uint32_t *bus_us) {
+    ssd1306_set_rotation(&disp, r, false);
+    ssd1306_show(&disp);
+
+    // a pattern, so the transposes have something to move
+    for(uint32_t x=0; x<disp.width; ++x)
+        ssd1306_draw_line(&disp, x, 0, disp.width-1-x, disp.height-1);
+    ssd1306_show(&disp);
+    ssd1306_emu_end_frame(&e, NULL);
+
+    const double t0=seconds();
+    for(uint32_t i=0; i<flushes; ++i) {
+        if(full)
+            ssd1306_invalidate(&disp);
+        else
+            ssd1306_mark_dirty(&disp, 8, 8, 8, 8);
+        ssd1306_show(&disp);
+    }
+    const double t=seconds()-t0;
+
+    ssd1306_emu_stats_t s;
+    ssd1306_emu_end_frame(&e, &s);
+    s.bits/=flushes;
+    *bus_us=ssd1306_emu_bus_time_us(&s, I2C_HZ);
+    return t*1e6/flushes;
+}
+
+static void report(const char *name, bool full, uint32_t flushes) {
+    uint32_t bus0, bus90;
+    const double t0=bench(SSD1306_ROTATE_0, full, flushes, &bus0);
+    const double t90=bench(SSD1306_ROTATE_90, full, flushes, &bus90);
+    printf("%-6s flush: upright %7.3f us, rotated %7.3f us, transpose %7.3f us; i2c %lu us (%.3f%%)\n",
+           name, t0, t90, t90-t0, (unsigned long) bus90, (t90-t0)*100/bus90);
+}
+
+int main(int argc, char **argv) {
+    const uint32_t flushes=argc>1?strtoul(argv[1], NULL, 0):100000;
+    if(!flushes) {
+        fprintf(stderr, "usage: %s [flushes]\n", argv[0]);
+        return 2;
+    }
+
+    ssd1306_emu_init(&e, 0x3c, 128, 64);
+    ssd1306_emu_attach(&e, &disp);
+    if(!ssd1306_init_transport(&disp, &ssd1306_emu_transport, 128, 64, 0x3c, i2c1, NULL, NULL)) {
+        fprintf(stderr, "display init failed\n");
+        return 1;
+    }
+
+    report("full", true, flushes);
+    report("block", false, flushes);
+
+    ssd1306_deinit(&disp);
+    ssd1306_emu_detach(&disp);
+    return 0;
+}
@@ -0,0 +1,337 @@
+#!/usr/bin/env python3
+"""
+Font compiler for the ssd1306 driver
+
+Converts a BDF font or a PBM glyph sheet into a C header in one of the
+formats described in font.h. Only the characters the firmware uses need
+to be kept (--chars), glyph data can be run length encoded (--rle) and
+the flash taken by the font is reported.
+
+    ssd1306_fontc.py font.bdf -n font_digits --chars "0123456789dB" --rle -o font_digits.h
+    ssd1306_fontc.py sheet.pbm --cell 6x8 --first 32 -n font_6x8 -o font_6x8.h
+
+Glyph sheets are plain or raw PBM images holding cells of --cell size,
+left to right and top to bottom, starting at character --first.
+"""
+
+import argparse
+import os
+import sys
+
+
+class Glyph:
+    def __init__(self, code, columns, width):
+        self.code=code
+        self.columns=columns    # one int per column, bit 0 on top
+        self.width=width
+
+
+def parse_bdf(path):
+    glyphs={}
+    ascent=descent=None
+    bbox=None
+    with open(path, encoding='latin-1') as f:
+        lines=iter(f.read().splitlines())
+
+    for line in lines:
+        words=line.split()
+        if not words:
+            continue
+        if words[0]=='FONTBOUNDINGBOX':
+            bbox=[int(v) for v in words[1:5]]
+        elif words[0]=='FONT_ASCENT':
+            ascent=int(words[1])
+        elif words[0]=='FONT_DESCENT':
+            descent=int(words[1])
+        elif words[0]=='STARTCHAR':
+            code=-1
+            dwidth=None
+            bbx=None
+            rows=[]
+            for line in lines:
+                words=line.split()
+                if not words:
+                    continue
+                if words[0]=='ENCODING':
+                    code=int(words[1])
+                elif words[0]=='DWIDTH':
+                    dwidth=int(words[1])
+                elif words[0]=='BBX':
+                    bbx=[int(v) for v in words[1:5]]
+                elif words[0]=='BITMAP':
+                    for line in lines:
+                        if line.strip()=='ENDCHAR':
+                            break
+                        rows.append(line.strip())
+                    break
+            if 0<=code<256 and bbx:
+                glyphs[code]=(dwidth if dwidth is not None else bbx[0], bbx, rows)
+
+    if bbox is None:
+        sys.exit(f'{path}: no FONTBOUNDINGBOX')
+    if ascent is None:
+        ascent=bbox[1]+bbox[3]
+    if descent is None:
+        descent=-bbox[3]
+    height=ascent+descent
+
+    out={}
+    for code, (dwidth, (w, h, xoff, yoff), rows) in glyphs.items():
+        width=max(dwidth, xoff+w, 0)
+        columns=[0]*width
+        top=ascent-(yoff+h)
+        for r, hexrow in enumerate(rows[:h]):
+            bits=int(hexrow, 16) if hexrow else 0
+            nbits=len(hexrow)*4
+            y=top+r
+            if not 0<=y<height:
+                continue
+            for c in range(w):
+                if bits>>(nbits-1-c)&1 and 0<=xoff+c<width:
+                    columns[xoff+c]|=1<<y
+        out[code]=Glyph(code, columns, width)
+    return height, out
+
+
+def parse_pbm(path, cell, first):
+    with open(path, 'rb') as f:
+        data=f.read()
+
+    # header: magic, width, height, comments allowed in between
+    tokens=[]
+    pos=0
+    while len(tokens)<3:
+        while data[pos:pos+1].isspace():
+            pos+=1
+        if data[pos:pos+1]==b'#':
+            while data[pos:pos+1] not in (b'\n', b''):
+                pos+=1
+            continue
+        start=pos
+        while not data[pos:pos+1].isspace():
+            pos+=1
+        tokens.append(data[start:pos])
+    magic, width, height=tokens[0], int(tokens[1]), int(tokens[2])
+
+    if magic==b'P4':
+        pos+=1
+        stride=(width+7)//8
+        pixel=lambda x, y: data[pos+y*stride+(x>>3)]>>(7-(x&7))&1
+    elif magic==b'P1':
+        bits=[c-48 for c in data[pos:] if c in b'01']
+        pixel=lambda x, y: bits[y*width+x]
+    else:
+        sys.exit(f'{path}: not a PBM image')
+
+    cw, ch=cell
+    out={}
+    code=first
+    for cy in range(height//ch):
+        for cx in range(width//cw):
+            if code>255:
+                break
+            columns=[0]*cw
+            for x in range(cw):
+                for y in range(ch):
+                    if pixel(cx*cw+x, cy*ch+y):
+                        columns[x]|=1<<y
+            out[code]=Glyph(code, columns, cw)
+            code+=1
+    return ch, out
+
+
+def trim(glyph):
+    # proportional fonts: drop the empty columns around the ink, blank glyphs keep their width
+    cols=glyph.columns
+    if not any(cols):
+        return Glyph(glyph.code, cols[:max(glyph.width-1, 1)], max(glyph.width-1, 1))
+    left=next(i for i, c in enumerate(cols) if c)
+    right=len(cols)-next(i for i, c in enumerate(reversed(cols)) if c)
+    return Glyph(glyph.code, cols[left:right], right-left)
+
+
+def page_bytes(glyph, parts):
+    out=[]
+    for col in glyph.columns:
+        out.extend((col>>(8*i))&0xff for i in range(parts))
+    return out
+
+
+def rle(data):
+    # same runs ssd1306_rle_decode() expects: 0x80+n-2 repeats, n-1 literals
+    out=[]
+    i=0
+    literal=[]
+
+    def flush():
+        while literal:
+            chunk=literal[:128]
+            del literal[:128]
+            out.append(len(chunk)-1)
+            out.extend(chunk)
+
+    while i<len(data):
+        n=1
+        while i+n<len(data) and data[i+n]==data[i] and n<129:
+            n+=1
+        if n>=3 or (n==2 and not literal):
+            flush()
+            out.extend((0x80+n-2, data[i]))
+            i+=n
+        else:
+            literal.append(data[i])
+            i+=1
+    flush()
+    return out
+
+
+def parse_chars(args):
+    chars=set()
+    if args.chars:
+        chars.update(ord(c) for c in args.chars)
+    for r in args.range or []:
+        a, _, b=r.partition('-')
+        chars.update(range(int(a, 0), int(b or a, 0)+1))
+    if not chars:
+        chars.update(range(32, 127))
+    return chars
+
+
+def parse_kerning(pairs):
+    out=[]
+    for pair in pairs or []:
+        # "AV:-1"
+        chars, _, adj=pair.rpartition(':')
+        if len(chars)!=2 or not -128<=int(adj)<=127:
+            sys.exit(f'bad kerning pair {pair!r}, expected e.g. AV:-1')
+        out.append((ord(chars[0]), ord(chars[1]), int(adj)))
+    return out
+
+
+def compile_font(height, glyphs, args):
+    if height<1 or height>32:
+        sys.exit(f'font height {height} is not supported (1..32)')
+
+    codes=sorted(c for c in parse_chars(args) if c in glyphs)
+    if not codes:
+        sys.exit('none of the requested characters are in the font')
+    missing=sorted(c for c in parse_chars(args) if c not in glyphs and 32<=c<127)
+    if missing:
+        print(f'warning: not in the font: {"".join(map(chr, missing))!r}', file=sys.stderr)
+
+    parts=(height+7)//8
+    first, last=codes[0], codes[-1]
+
+    if args.fixed:
+        width=max(glyphs[c].width for c in codes)
+        data=[]
+        for c in range(first, last+1):
+            g=glyphs.get(c) if c in codes else None
+            cols=(g.columns if g else [])+[0]*width
+            data.extend(page_bytes(Glyph(c, cols[:width], width), parts))
+        font=[height, width, args.spacing, first, last]+data
+        return font, {'index': 0, 'kerning': 0, 'data': len(data), 'raw': len(data), 'glyphs': len(codes)}
+
+    kerning=[k for k in parse_kerning(args.kern) if k[0] in codes and k[1] in codes]
+    index=[]
+    data=[]
+    raw=0
+    for c in range(first, last+1):
+        if c not in codes:
+            index.extend((0, 0, 0))
+            continue
+        g=glyphs[c] if args.no_trim else trim(glyphs[c])
+        if g.width>255:
+            sys.exit(f'glyph {c} is wider than 255 columns')
+        glyph=page_bytes(g, parts)
+        raw+=len(glyph)
+        if args.rle:
+            # compressed page by page: blank rows and horizontal strokes become runs
+            glyph=rle([glyph[c*parts+k] for k in range(parts) for c in range(g.width)])
+        index.extend((len(data)&0xff, len(data)>>8, g.width))
+        data.extend(glyph)
+        if len(data)>0xffff:
+            sys.exit('glyph data does not fit 16 bit offsets')
+
+    if args.rle and len(data)>=raw:
+        print(f'note: run length encoding does not make {args.name} smaller, storing it uncompressed', file=sys.stderr)
+        args.rle=False
+        return compile_font(height, glyphs, args)
+
+    flags=0x01 if args.rle else 0x00
+    font=[0, flags, height, args.spacing, first, last, len(kerning)]+index
+    for l, r, adj in kerning:
+        font.extend((l, r, adj&0xff))
+    font+=data
+    return font, {'index': len(index), 'kerning': 3*len(kerning), 'data': len(data), 'raw': raw, 'glyphs': len(codes)}
+
+
+def emit(font, stats, args, source):
+    lines=[]
+    guard='_inc_'+args.name
+    lines.append(f'// generated by tools/ssd1306_fontc.py from {os.path.basename(source)}, do not edit')
+    lines.append(f'// {report(font, stats, args.name)}')
+    lines.append(f'#ifndef {guard}')
+    lines.append(f'#define {guard}')
+    lines.append('')
+    lines.append('#include <stdint.h>')
+    lines.append('')
+    lines.append(f'static const uint8_t {args.name}[] =')
+    lines.append('{')
+    for i in range(0, len(font), 12):
+        lines.append('\t\t\t'+', '.join(f'0x{b:02X}' for b in font[i:i+12])+',')
+    lines.append('};')
+    lines.append('')
+    lines.append('#endif')
+    return '\n'.join(lines)+'\n'
+
+
+def report(font, stats, name):
+    text=f'{name}: {stats["glyphs"]} glyphs, {len(font)} bytes of flash'
+    text+=f' (index {stats["index"]}, kerning {stats["kerning"]}, data {stats["data"]}'
+    if stats['raw']!=stats['data']:
+        text+=f', {stats["raw"]} uncompressed'
+    return text+')'
+
+
+def main():
+    ap=argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument('input', help='BDF font or PBM glyph sheet')
+    ap.add_argument('-n', '--name', required=True, help='name of the generated array')
+    ap.add_argument('-o', '--output', help='header to write, stdout if omitted')
+    ap.add_argument('--chars', help='characters to keep, e.g. "0123456789dB"')
+    ap.add_argument('--range', action='append', help='character codes to keep, e.g. 32-126 (repeatable)')
+    ap.add_argument('--cell', help='glyph sheets: cell size as WxH')
+    ap.add_argument('--first', type=int, default=32, help='glyph sheets: character of the first cell')
+    ap.add_argument('--spacing', type=int, default=1, help='additional columns between characters')
+    ap.add_argument('--fixed', action='store_true', help='fixed width format (no subsetting of the index, no RLE)')
+    ap.add_argument('--no-trim', action='store_true', help='keep blank columns around proportional glyphs')
+    ap.add_argument('--rle', action='store_true', help='run length encode the glyph data')
+    ap.add_argument('--kern', action='append', help='kerning pair, e.g. AV:-1 (repeatable)')
+    args=ap.parse_args()
+
+    if args.fixed and (args.rle or args.kern):
+        ap.error('--rle and --kern need the proportional format')
+
+    if args.input.lower().endswith('.bdf'):
+        height, glyphs=parse_bdf(args.input)
+    else:
+        if not args.cell:
+            ap.error('glyph sheets need --cell WxH')
+        w, _, h=args.cell.partition('x')
+        height, glyphs=parse_pbm(args.input, (int(w), int(h)), args.first)
+
+    font, stats=compile_font(height, glyphs, args)
+    text=emit(font, stats, args, args.input)
+
+    if args.output:
+        with open(args.output, 'w') as f:
+            f.write(text)
+    else:
+        sys.stdout.write(text)
+
+    print(report(font, stats, args.name))
+
+
+if __name__=='__main__':
+    main()
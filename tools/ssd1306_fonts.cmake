@@ -0,0 +1,62 @@
+# Build time fonts for the ssd1306 driver
+#
+# ssd1306_add_font(<target> <name> <source>
+#                  [CHARS <characters>] [RANGE <first-last> ...]
+#                  [CELL <WxH>] [FIRST <char code>] [SPACING <columns>]
+#                  [KERN <pair:adjustment> ...] [RLE] [FIXED])
+#
+# Compiles a BDF font or PBM glyph sheet with tools/ssd1306_fontc.py into
+# fonts/<name>.h in the build directory and makes it includable from
+# <target>. The flash used by the font is printed when it is generated.
+#
+#   ssd1306_add_font(tarefa6Vitor font_digits ${CMAKE_CURRENT_LIST_DIR}/fonts/big.bdf
+#                    CHARS "0123456789dB" RLE)
+
+find_package(Python3 REQUIRED COMPONENTS Interpreter)
+
+set(SSD1306_FONTC ${CMAKE_CURRENT_LIST_DIR}/ssd1306_fontc.py)
+
+function(ssd1306_add_font target name source)
+    cmake_parse_arguments(FONT "RLE;FIXED" "CHARS;CELL;FIRST;SPACING" "RANGE;KERN" ${ARGN})
+
+    set(out_dir ${CMAKE_CURRENT_BINARY_DIR}/fonts)
+    set(header ${out_dir}/${name}.h)
+
+    set(args ${source} -n ${name} -o ${header})
+    if(DEFINED FONT_CHARS)
+        list(APPEND args --chars ${FONT_CHARS})
+    endif()
+    foreach(range IN LISTS FONT_RANGE)
+        list(APPEND args --range ${range})
+    endforeach()
+    if(DEFINED FONT_CELL)
+        list(APPEND args --cell ${FONT_CELL})
+    endif()
+    if(DEFINED FONT_FIRST)
+        list(APPEND args --first ${FONT_FIRST})
+    endif()
+    if(DEFINED FONT_SPACING)
+        list(APPEND args --spacing ${FONT_SPACING})
+    endif()
+    foreach(pair IN LISTS FONT_KERN)
+        list(APPEND args --kern ${pair})
+    endforeach()
+    if(FONT_RLE)
+        list(APPEND args --rle)
+    endif()
+    if(FONT_FIXED)
+        list(APPEND args --fixed)
+    endif()
+
+    add_custom_command(
+        OUTPUT ${header}
+        COMMAND ${CMAKE_COMMAND} -E make_directory ${out_dir}
+        COMMAND Python3::Interpreter ${SSD1306_FONTC} ${args}
+        DEPENDS ${source} ${SSD1306_FONTC}
+        COMMENT "Compiling font ${name}"
+        VERBATIM
+    )
+
+    target_sources(${target} PRIVATE ${header})
+    target_include_directories(${target} PRIVATE ${out_dir})
+endfunction()
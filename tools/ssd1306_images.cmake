@@ -0,0 +1,47 @@
+# Build time images for the ssd1306 driver
+#
+# ssd1306_add_image(<target> <name> <source>
+#                   [MASK <mask image>] [INVERT] [THRESHOLD <grey level>])
+#
+# Converts a monochrome BMP, PBM or PGM image with tools/ssd1306_imgc.py
+# into images/<name>.h in the build directory, ready for
+# ssd1306_blit_page_image() (ssd1306_sprite.h), and makes it includable
+# from <target>. The flash used by the image is printed when it is generated.
+#
+#   ssd1306_add_image(tarefa6Vitor logo ${CMAKE_CURRENT_LIST_DIR}/images/logo.bmp)
+
+find_package(Python3 REQUIRED COMPONENTS Interpreter)
+
+set(SSD1306_IMGC ${CMAKE_CURRENT_LIST_DIR}/ssd1306_imgc.py)
+
+function(ssd1306_add_image target name source)
+    cmake_parse_arguments(IMAGE "INVERT" "THRESHOLD;MASK" "" ${ARGN})
+
+    set(out_dir ${CMAKE_CURRENT_BINARY_DIR}/images)
+    set(header ${out_dir}/${name}.h)
+
+    set(args ${source} -n ${name} -o ${header})
+    if(IMAGE_INVERT)
+        list(APPEND args --invert)
+    endif()
+    if(DEFINED IMAGE_THRESHOLD)
+        list(APPEND args --threshold ${IMAGE_THRESHOLD})
+    endif()
+    set(depends ${source})
+    if(DEFINED IMAGE_MASK)
+        list(APPEND args --mask ${IMAGE_MASK})
+        list(APPEND depends ${IMAGE_MASK})
+    endif()
+
+    add_custom_command(
+        OUTPUT ${header}
+        COMMAND ${CMAKE_COMMAND} -E make_directory ${out_dir}
+        COMMAND Python3::Interpreter ${SSD1306_IMGC} ${args}
+        DEPENDS ${depends} ${SSD1306_IMGC}
+        COMMENT "Converting image ${name}"
+        VERBATIM
+    )
+
+    target_sources(${target} PRIVATE ${header})
+    target_include_directories(${target} PRIVATE ${out_dir})
+endfunction()
@@ -0,0 +1,165 @@
+#!/usr/bin/env python3
+"""
+Image converter for the ssd1306 driver
+
+Converts a monochrome BMP, a PBM or a PGM image into a C header holding
+the image in display layout: width bytes per page of 8 rows, least
+significant bit on top. Draw it with ssd1306_blit_page_image() from
+ssd1306_sprite.h.
+
+    ssd1306_imgc.py logo.bmp -n logo -o logo.h
+
+    ssd1306_blit_page_image(&disp, 0, 0, logo, LOGO_WIDTH, LOGO_HEIGHT);
+
+Black pixels are lit, like ssd1306_bmp_show_image(); --invert lights
+the white ones. PGM images are split at --threshold. --mask adds a
+<name>_mask array from a second image of the same size, for sprites
+drawn with SSD1306_ROP_MASKED (black pixels of the mask are opaque).
+"""
+
+import argparse
+import os
+import struct
+import sys
+
+
+def read_netpbm(data, threshold):
+    # header: magic, width, height[, maxval], comments allowed in between
+    magic=data[:2]
+    count=2 if magic in (b'P1', b'P4') else 3
+    tokens=[]
+    pos=2
+    while len(tokens)<count:
+        while data[pos:pos+1].isspace():
+            pos+=1
+        if data[pos:pos+1]==b'#':
+            while data[pos:pos+1] not in (b'\n', b''):
+                pos+=1
+            continue
+        start=pos
+        while not data[pos:pos+1].isspace():
+            pos+=1
+        tokens.append(int(data[start:pos]))
+    width, height=tokens[0], tokens[1]
+    maxval=tokens[2] if count==3 else 1
+    pos+=1
+
+    if magic==b'P1':
+        bits=[c-48 for c in data[pos:] if c in b'01']
+        return width, height, lambda x, y: bits[y*width+x]
+    if magic==b'P4':
+        stride=(width+7)//8
+        return width, height, lambda x, y: data[pos+y*stride+(x>>3)]>>(7-(x&7))&1
+    if magic==b'P2':
+        values=[int(v) for v in data[pos-1:].split()]
+        return width, height, lambda x, y: values[y*width+x]*255//maxval<threshold
+    if magic==b'P5':
+        size=2 if maxval>255 else 1
+        def pixel(x, y):
+            v=int.from_bytes(data[pos+(y*width+x)*size:pos+(y*width+x+1)*size], 'big')
+            return v*255//maxval<threshold
+        return width, height, pixel
+    sys.exit('not a PBM/PGM image')
+
+
+def read_bmp(data):
+    off, =struct.unpack_from('<I', data, 10)
+    header, width, height, _, bits, compression=struct.unpack_from('<IiiHHI', data, 14)
+    if bits!=1 or compression!=0:
+        sys.exit('only uncompressed 1 bit BMP images are supported')
+
+    # the palette entry that is black gets drawn
+    table=14+header
+    black=0
+    for i in range(2):
+        b, g, r=data[table+4*i:table+4*i+3]
+        if not (r|g|b):
+            black=i
+            break
+
+    stride=((width+31)//32)*4
+    rows=abs(height)
+
+    def pixel(x, y):
+        row=rows-1-y if height>0 else y
+        return (data[off+row*stride+(x>>3)]>>(7-(x&7))&1)==black
+    return width, rows, pixel
+
+
+def read_image(path, threshold):
+    with open(path, 'rb') as f:
+        data=f.read()
+
+    if data[:2]==b'BM':
+        return read_bmp(data)
+    return read_netpbm(data, threshold)
+
+
+def pages(width, height, pixel, invert):
+    out=[]
+    for page in range((height+7)//8):
+        for x in range(width):
+            v=0
+            for bit in range(8):
+                y=page*8+bit
+                if y<height and bool(pixel(x, y))!=invert:
+                    v|=1<<bit
+            out.append(v)
+    return out
+
+
+def main():
+    ap=argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument('input', help='BMP, PBM or PGM image')
+    ap.add_argument('-n', '--name', required=True, help='name of the generated array')
+    ap.add_argument('-o', '--output', help='header to write, stdout if omitted')
+    ap.add_argument('--invert', action='store_true', help='light the white pixels instead of the black ones')
+    ap.add_argument('--threshold', type=int, default=128, help='PGM images: grey levels below this are black')
+    ap.add_argument('--mask', help='image whose black pixels are the opaque part of the sprite')
+    args=ap.parse_args()
+
+    width, height, pixel=read_image(args.input, args.threshold)
+    image=pages(width, height, pixel, args.invert)
+
+    arrays=[(args.name, image)]
+    if args.mask:
+        mask_width, mask_height, mask_pixel=read_image(args.mask, args.threshold)
+        if (mask_width, mask_height)!=(width, height):
+            sys.exit(f'{args.mask}: mask is {mask_width}x{mask_height}, image is {width}x{height}')
+        arrays.append((args.name+'_mask', pages(width, height, mask_pixel, False)))
+
+    report=f'{args.name}: {width}x{height}, {sum(len(a) for _, a in arrays)} bytes of flash'
+
+    upper=args.name.upper()
+    lines=[
+        f'// generated by tools/ssd1306_imgc.py from {os.path.basename(args.input)}, do not edit',
+        f'// {report}',
+        f'#ifndef _inc_{args.name}',
+        f'#define _inc_{args.name}',
+        '',
+        '#include <stdint.h>',
+        '',
+        f'#define {upper}_WIDTH {width}',
+        f'#define {upper}_HEIGHT {height}',
+    ]
+    for name, data in arrays:
+        lines+=['', f'static const uint8_t {name}[] =', '{']
+        for page in range((height+7)//8):
+            row=data[page*width:(page+1)*width]
+            for i in range(0, width, 16):
+                lines.append('\t\t\t'+', '.join(f'0x{b:02X}' for b in row[i:i+16])+',')
+        lines.append('};')
+    lines+=['', '#endif']
+    text='\n'.join(lines)+'\n'
+
+    if args.output:
+        with open(args.output, 'w') as f:
+            f.write(text)
+    else:
+        sys.stdout.write(text)
+
+    print(report)
+
+
+if __name__=='__main__':
+    main()